@@ -23,8 +23,23 @@ struct database_import_state_t : public generic_state_t
     };
 
   state_t * state;
+  ///\brief events applied before journal transaction is committed with checkpoint of position reached, 0 commits
+  /// once per journal
+  uint32_t commit_every_{};
+  uint32_t uncommitted_events_{};
 
-  explicit database_import_state_t(std::string_view journal_dir) : generic_state_t{journal_dir} {}
+  explicit database_import_state_t(std::string_view journal_dir) : generic_state_t{journal_dir, events::import_events}
+    {
+    }
+
+  void handle(std::chrono::sys_seconds timestamp, events::event_holder_t const & event) override;
+  ///\brief writes of chunk are grouped into transaction, nested in journal transaction when one is open
+  void begin_chunk() override;
+  void end_chunk() override;
 
-  void handle(std::chrono::sys_seconds timestamp, events::event_holder_t && event) override;
+  ///\brief commits journal transaction together with checkpoint once commit_every_ events were applied
+  ///\details called between chunks, checkpoint records position past last applied line so import resumed after
+  /// interruption does not apply committed events again
+  [[nodiscard]]
+  auto commit_progress(journal_checkpoint_t const & checkpoint) -> expected_ec<void>;
   };
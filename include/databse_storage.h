@@ -6,26 +6,264 @@
 #include <elite_events.h>
 #include <elite_data.h>
 #include <array>
+#include <exception>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 struct sqlite3_handle_t;
+struct sqlite3_stmt;
 
 template<typename T>
 using expected_ec = cxx23::expected<T, std::error_code>;
 
+///\brief how far journal was imported, allows to resume import without replaying whole history
+struct journal_checkpoint_t
+  {
+  std::string journal;  ///< file name without directory
+  uint64_t file_size;   ///< size of journal when checkpoint was stored
+  int64_t mtime;        ///< last write time of journal in seconds since epoch when checkpoint was stored
+  uint64_t offset;      ///< offset just past last imported complete line
+  std::chrono::sys_seconds last_event;
+  uint64_t system_address;  ///< current system at offset, 0 when unknown
+  };
+
+///\brief system found by spatial query
+struct nearby_system_t
+  {
+  uint64_t system_address;
+  std::string name;
+  info::space_location_t location;
+  ///\brief distance in ly from center of query, 0 for box query
+  double distance;
+  };
+
+///\brief kind of record found by name search
+enum struct name_kind_e : uint8_t
+  {
+  star_system,
+  body,
+  faction,
+  mission_destination
+  };
+
+consteval auto adl_enum_bounds(name_kind_e)
+  {
+  using enum name_kind_e;
+  return simple_enum::adl_info{star_system, mission_destination};
+  }
+
+///\brief record found by name search
+struct name_match_t
+  {
+  name_kind_e kind;
+  ///\brief system_address of system and body, oid of faction, mission_id of mission destination
+  uint64_t ref;
+  std::string name;
+  ///\brief system of body, station and settlement of mission destination, empty otherwise
+  std::string context;
+  ///\brief bm25 rank, lower is better match
+  double rank;
+  };
+
+///\brief body row of full table scan, details hold default alternative of stored body type and are not loaded
+struct system_body_t
+  {
+  uint64_t system_address;
+  body_t body;
+  };
+
+///\brief forward only cursor stepping its own prepared statement, rows are read and converted one at a time
+///\details full table scans run in constant memory, cursor must not outlive database_storage_t that created it,
+/// iteration as range stops on error which is available from error()
+template<typename row_type>
+struct row_cursor_t
+  {
+  sqlite3_stmt * stmt_{};
+  std::error_code error_;
+
+  row_cursor_t() noexcept = default;
+
+  explicit row_cursor_t(sqlite3_stmt * stmt) noexcept : stmt_{stmt} {}
+
+  row_cursor_t(row_cursor_t && other) noexcept : stmt_{std::exchange(other.stmt_, nullptr)}, error_{other.error_} {}
+
+  auto operator=(row_cursor_t && other) noexcept -> row_cursor_t &
+    {
+    std::swap(stmt_, other.stmt_);
+    std::swap(error_, other.error_);
+    return *this;
+    }
+
+  ~row_cursor_t();
+
+  ///\brief reads next row, empty when all rows were read
+  [[nodiscard]]
+  auto next() -> expected_ec<std::optional<row_type>>;
+
+  ///\brief replaces content of batch with at most max_rows next rows, capacity of batch is reused
+  ///\returns number of rows read, 0 when all rows were read
+  [[nodiscard]]
+  auto next_batch(std::vector<row_type> & batch, std::size_t max_rows) -> expected_ec<std::size_t>;
+
+  [[nodiscard]]
+  auto error() const noexcept -> std::error_code
+    {
+    return error_;
+    }
+
+  struct iterator_t
+    {
+    using value_type = row_type;
+    using difference_type = std::ptrdiff_t;
+
+    row_cursor_t * cursor_{};
+    std::optional<row_type> current_;
+
+    auto operator*() const noexcept -> row_type const & { return *current_; }
+
+    auto operator++() -> iterator_t &
+      {
+      auto res{cursor_->next()};
+      if(res)
+        current_ = std::move(*res);
+      else
+        {
+        cursor_->error_ = res.error();
+        current_.reset();
+        }
+      return *this;
+      }
+
+    auto operator++(int) -> void { ++*this; }
+
+    friend auto operator==(iterator_t const & it, std::default_sentinel_t) noexcept -> bool
+      {
+      return not it.current_.has_value();
+      }
+    };
+
+  [[nodiscard]]
+  auto begin() -> iterator_t
+    {
+    iterator_t it{.cursor_ = this};
+    ++it;
+    return it;
+    }
+
+  [[nodiscard]]
+  auto end() const noexcept -> std::default_sentinel_t
+    {
+    return std::default_sentinel;
+    }
+  };
+
+extern template struct row_cursor_t<star_system_t>;
+extern template struct row_cursor_t<system_body_t>;
+
+///\brief size bounded cache of fully loaded systems keyed by system_address, least recently used one is evicted
+struct system_cache_t
+  {
+  using entries_t = std::list<star_system_t>;
+
+  std::size_t capacity_;
+  ///\brief most recently used first
+  entries_t entries_;
+  std::unordered_map<uint64_t, entries_t::iterator> index_;
+  uint64_t hits_{};
+  uint64_t misses_{};
+
+  explicit system_cache_t(std::size_t capacity) noexcept : capacity_{capacity} {}
+
+  ///\brief cached system marked as most recently used, nullptr when not cached
+  [[nodiscard]]
+  auto find(uint64_t system_address) -> star_system_t const *;
+
+  ///\brief stores copy of system replacing cached one, evicts least recently used system when full
+  auto insert(star_system_t const & system) -> void;
+
+  auto erase(uint64_t system_address) noexcept -> void;
+
+  auto clear() noexcept -> void;
+  };
+
 struct database_storage_t
   {
   std::string db_path_;
   std::unique_ptr<sqlite3_handle_t> db_;
+  ///\brief number of open transaction scopes, only outermost one issues BEGIN and COMMIT
+  uint32_t transaction_depth_{};
+  ///\brief systems returned by load_system, entries are dropped by every write touching the system
+  system_cache_t system_cache_{16};
+  ///\brief stored state of factions by name, written by sync_factions and dropped by other faction writes
+  std::unordered_map<std::string, info::faction_info_t> faction_cache_;
+  ///\brief frames of write ahead log not copied into database yet, updated by commits of this connection
+  uint32_t wal_pages_{};
 
   explicit database_storage_t(std::string_view db_path);
   ~database_storage_t();
 
+  ///\brief opens database creating or upgrading schema, file databases are switched to write ahead log mode
+  ///\details writer calls checkpoint when it is idle, commit checkpoints by itself only when log grows large as
+  /// fallback for writers that never do, log is also checkpointed on close
   [[nodiscard]]
   auto open() -> expected_ec<void>;
 
+  ///\brief opens existing database for queries only, schema must be already upgraded by writer
+  ///\details systems are not cached as connection does not observe writes of other connections
+  [[nodiscard]]
+  auto open_read_only() -> expected_ec<void>;
+
+  ///\brief copies write ahead log into database when at least min_pages are pending
+  ///\details passive checkpoint does not wait for readers, skipped while transaction is open
+  [[nodiscard]]
+  auto checkpoint(uint32_t min_pages = 0) -> expected_ec<void>;
+
   [[nodiscard]]
   auto create_database() -> expected_ec<void>;
 
+  ///\brief upgrades schema of existing database to schema_version
+  [[nodiscard]]
+  auto migrate() -> expected_ec<void>;
+
+  ///\brief starts transaction, nested calls join already open one
+  [[nodiscard]]
+  auto begin_transaction() -> expected_ec<void>;
+
+  ///\brief ends transaction scope, writes are committed when outermost scope ends
+  ///\details outside of transaction it does nothing
+  [[nodiscard]]
+  auto commit_transaction() -> expected_ec<void>;
+
+  ///\brief discards all writes of open transaction regardless of nesting depth
+  ///\details cached systems and factions are dropped as they may contain discarded writes
+  auto rollback_transaction() -> void;
+
+  ///\brief commits writes made so far and continues with new transaction
+  ///\details allows to bound size of long running transaction, does nothing outside of transaction and while nested
+  /// scopes are open as their writes are not complete yet
+  [[nodiscard]]
+  auto commit_pending() -> expected_ec<void>;
+
+  [[nodiscard]]
+  auto in_transaction() const noexcept -> bool
+    {
+    return transaction_depth_ != 0;
+    }
+
+  [[nodiscard]]
+  auto store(journal_checkpoint_t const & value) -> expected_ec<void>;
+
+  [[nodiscard]]
+  auto load_checkpoint(std::string_view journal) -> expected_ec<std::optional<journal_checkpoint_t>>;
+
+  ///\brief checkpoint of newest imported journal
+  [[nodiscard]]
+  auto load_last_checkpoint() -> expected_ec<std::optional<journal_checkpoint_t>>;
+
   [[nodiscard]]
   auto store(info::mission_t const & value) -> expected_ec<void>;
   
@@ -53,8 +291,9 @@ struct database_storage_t
   [[nodiscard]]
   auto store(uint64_t system_address, bary_centre_t const & value) -> expected_ec<void>;
 
+  ///\brief stores body with its details, system_name is indexed as search context of body name
   [[nodiscard]]
-  auto store(uint64_t system_address, body_t const & value) -> expected_ec<uint64_t>;
+  auto store(uint64_t system_address, std::string_view system_name, body_t const & value) -> expected_ec<uint64_t>;
 
   [[nodiscard]]
   auto store_dss_complete(uint64_t system_address, events::body_id_t body_id) -> expected_ec<void>;
@@ -101,7 +340,80 @@ struct database_storage_t
   [[nodiscard]]
   auto update_faction_info(info::faction_info_t const & faction) -> expected_ec<void>;
 
+  ///\brief inserts new and updates changed factions with single upsert by name each, oids of factions are set
+  ///\details factions equal to faction_cache_ are skipped without touching database, writes share one transaction
+  /// which is rolled back on failure together with transaction of caller it joined
+  [[nodiscard]]
+  auto sync_factions(std::span<info::faction_info_t> factions) -> expected_ec<void>;
+
+  ///\brief loads system with bodies and rings, revisited systems are served from system_cache_
   [[nodiscard]]
   auto load_system(uint64_t system_address) -> expected_ec<std::optional<star_system_t>>;
+
+  ///\brief all systems ordered by system_address without bodies, rows are read while iterating
+  [[nodiscard]]
+  auto scan_systems() -> expected_ec<row_cursor_t<star_system_t>>;
+
+  ///\brief all bodies ordered by system, rows are read while iterating
+  [[nodiscard]]
+  auto scan_bodies() -> expected_ec<row_cursor_t<system_body_t>>;
+
+  ///\brief systems not farther than radius ly from center ordered by distance
+  ///\details spatial index does not contain systems stored without known location at origin
+  [[nodiscard]]
+  auto systems_within(info::space_location_t const & center, double radius)
+    -> expected_ec<std::vector<nearby_system_t>>;
+
+  ///\brief systems located inside axis aligned box
+  [[nodiscard]]
+  auto systems_in_box(info::space_location_t const & min_corner, info::space_location_t const & max_corner)
+    -> expected_ec<std::vector<nearby_system_t>>;
+
+  ///\brief at most count systems nearest to center ordered by distance
+  ///\details search radius is doubled until enough systems are found or it covers whole galaxy
+  [[nodiscard]]
+  auto nearest_systems(info::space_location_t const & center, std::size_t count)
+    -> expected_ec<std::vector<nearby_system_t>>;
+
+  ///\brief names containing words starting with words of text, best matches first
+  ///\details matches of name are ranked above matches of context, "shin dez" finds Shinrarta Dezhra
+  [[nodiscard]]
+  auto search_names(std::string_view text, std::size_t limit = 20) -> expected_ec<std::vector<name_match_t>>;
+
+  ///\brief names sharing most three letter sequences with text, tolerates misspelled and missing letters
+  ///\details text shorter than three letters is searched by search_names
+  [[nodiscard]]
+  auto search_names_fuzzy(std::string_view text, std::size_t limit = 20) -> expected_ec<std::vector<name_match_t>>;
+
+  ///\brief detail lines of EXPLAIN QUERY PLAN for query, allows to verify which indexes are used
+  [[nodiscard]]
+  auto query_plan(std::string_view query) -> expected_ec<std::vector<std::string>>;
+
+  ///\brief writes copy of database to target_path with sqlite backup api replacing existing file atomically
+  ///\details copy is written to target_path.tmp and renamed over target_path, so interrupted save never leaves
+  /// partially written database in place, write ahead log of target is checkpointed and removed before rename and
+  /// directory is synced after it so replacement survives power loss, fails when transaction is open or target is
+  /// used by other connection
+  [[nodiscard]]
+  auto save_as(std::string_view target_path) -> expected_ec<void>;
+
+  ///\brief replaces content of opened database with copy of database file at source_path and upgrades its schema
+  [[nodiscard]]
+  auto restore_from(std::string_view source_path) -> expected_ec<void>;
+
   auto close() -> void;
   };
+
+///\brief joins or starts transaction for its lifetime
+///\details commits when scope ends normally and rolls back whole transaction when it is left by exception
+struct transaction_scope_t
+  {
+  database_storage_t & db_;
+  int uncaught_exceptions_{std::uncaught_exceptions()};
+  bool active_{};
+
+  explicit transaction_scope_t(database_storage_t & db);
+  transaction_scope_t(transaction_scope_t const &) = delete;
+  auto operator=(transaction_scope_t const &) -> transaction_scope_t & = delete;
+  ~transaction_scope_t();
+  };
@@ -74,7 +74,7 @@ struct faction_info_t
   };
 
 [[nodiscard]]
-auto to_native(events::faction_info_t && faction) -> faction_info_t;
+auto to_native(events::faction_info_t const & faction) -> faction_info_t;
 
 enum struct mission_status_e : uint8_t
   {
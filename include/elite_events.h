@@ -1,6 +1,14 @@
 #pragma once
 #include <variant>
 #include <string>
+#include <optional>
+#include <span>
+#include <atomic>
+#include <bitset>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
 #include <simple_enum/glaze_json_enum_name.hpp>
 #include <chrono>
 
@@ -236,6 +244,151 @@ consteval auto adl_enum_bounds(event_e)
   using enum event_e;
   return simple_enum::adl_info{FSDTarget, NavRouteClear};
   }
+
+inline constexpr std::size_t event_count{std::to_underlying(event_e::NavRouteClear) + 1u};
+
+///\brief set of events processed by consumer, lines with other events are dropped before any JSON parsing
+struct event_filter_t
+  {
+  std::bitset<event_count> accepted;
+
+  constexpr event_filter_t() noexcept = default;
+
+  constexpr event_filter_t(std::initializer_list<event_e> list) noexcept
+    {
+    for(event_e e: list)
+      accepted.set(std::to_underlying(e));
+    }
+
+  [[nodiscard]]
+  constexpr auto accepts(event_e e) const noexcept -> bool
+    {
+    return accepted.test(std::to_underlying(e));
+    }
+
+  [[nodiscard]]
+  constexpr auto is_subset_of(event_filter_t const & other) const noexcept -> bool
+    {
+    return (accepted & ~other.accepted).none();
+    }
+  };
+
+///\brief events with typed structures, used by UI
+inline constexpr event_filter_t handled_events{
+  event_e::FSDJump,          event_e::FSDTarget,         event_e::StartJump,       event_e::FSSDiscoveryScan,
+  event_e::FSSBodySignals,   event_e::FSSAllBodiesFound, event_e::ScanBaryCentre,  event_e::Scan,
+  event_e::SAAScanComplete,  event_e::SAASignalsFound,   event_e::NavRoute,        event_e::NavRouteClear,
+  event_e::FuelScoop,        event_e::Loadout,           event_e::Location,        event_e::MissionAbandoned,
+  event_e::MissionAccepted,  event_e::MissionCompleted,  event_e::MissionFailed,   event_e::MissionRedirected,
+  event_e::Missions,         event_e::Cargo
+};
+
+///\brief events stored in database by importer, ship state is not needed
+inline constexpr event_filter_t import_events{
+  event_e::FSDJump,          event_e::StartJump,         event_e::FSSDiscoveryScan, event_e::FSSBodySignals,
+  event_e::FSSAllBodiesFound, event_e::ScanBaryCentre,   event_e::Scan,             event_e::SAAScanComplete,
+  event_e::SAASignalsFound,  event_e::NavRoute,          event_e::NavRouteClear,    event_e::Location,
+  event_e::MissionAbandoned, event_e::MissionAccepted,   event_e::MissionCompleted, event_e::MissionFailed,
+  event_e::MissionRedirected, event_e::Missions
+};
+
+static_assert(import_events.is_subset_of(handled_events));
+static_assert(not import_events.accepts(event_e::Loadout));
+
+namespace detail
+  {
+  inline constexpr std::size_t event_name_table_size{4096};
+
+  [[nodiscard]]
+  constexpr auto fnv1a(uint32_t seed, std::string_view text) noexcept -> uint32_t
+    {
+    uint32_t hash{2166136261u ^ seed};
+    for(char c: text)
+      {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 16777619u;
+      }
+    return hash;
+    }
+
+  [[nodiscard]]
+  constexpr auto event_name_slot(uint32_t seed, std::string_view name) noexcept -> std::size_t
+    {
+    return fnv1a(seed, name) & (event_name_table_size - 1u);
+    }
+
+  struct event_name_table_t
+    {
+    uint32_t seed;
+    /// event_e ordinal + 1 for each slot, 0 for empty slot
+    std::array<uint8_t, event_name_table_size> slots;
+    };
+
+  ///\brief searches seed for which all event names hash into distinct slots
+  consteval auto make_event_name_table() -> event_name_table_t
+    {
+    static_assert(event_count < 255u);
+    for(uint32_t seed{}; seed != 100'000u; ++seed)
+      {
+      std::array<uint64_t, event_name_table_size / 64u> used{};
+      bool collision{};
+      for(std::size_t i{}; i != event_count and not collision; ++i)
+        {
+        std::size_t const slot{event_name_slot(seed, simple_enum::enum_name(static_cast<event_e>(i)))};
+        uint64_t const bit{uint64_t{1} << (slot % 64u)};
+        collision = (used[slot / 64u] & bit) != 0;
+        used[slot / 64u] |= bit;
+        }
+      if(collision)
+        continue;
+      event_name_table_t table{.seed = seed, .slots = {}};
+      for(std::size_t i{}; i != event_count; ++i)
+        {
+        std::size_t const slot{event_name_slot(seed, simple_enum::enum_name(static_cast<event_e>(i)))};
+        table.slots[slot] = static_cast<uint8_t>(i + 1u);
+        }
+      return table;
+      }
+    throw "perfect hash seed not found, increase event_name_table_size";
+    }
+
+  inline constexpr event_name_table_t event_name_table{make_event_name_table()};
+  }  // namespace detail
+
+///\brief maps event name to event_e with single hash and one string compare, does not allocate
+[[nodiscard]]
+constexpr auto event_from_name(std::string_view name) noexcept -> std::optional<event_e>
+  {
+  uint8_t const entry{detail::event_name_table.slots[detail::event_name_slot(detail::event_name_table.seed, name)]};
+  if(entry == 0u)
+    return std::nullopt;
+  auto const e{static_cast<event_e>(entry - 1u)};
+  if(simple_enum::enum_name(e) != name)
+    return std::nullopt;
+  return e;
+  }
+
+static_assert(
+  []
+  {
+    for(std::size_t i{}; i != event_count; ++i)
+      {
+      auto const e{static_cast<event_e>(i)};
+      if(event_from_name(simple_enum::enum_name(e)) != e)
+        return false;
+      }
+    return true;
+  }()
+);
+static_assert(not event_from_name("Scann"));
+static_assert(not event_from_name(""));
+
+///\brief lines dropped by event_filter_t, updated concurrently by parsing threads
+struct event_filter_stats_t
+  {
+  std::atomic<uint64_t> skipped_lines{};
+  std::atomic<uint64_t> skipped_bytes{};
+  };
 enum struct scan_type_e
   {
   AutoScan,
@@ -325,9 +478,10 @@ struct start_jump_t
   {
   std::chrono::sys_seconds timestamp;
   jump_type_e JumpType;
-  std::optional<std::string> StarSystem;
+  ///\brief empty for supercruise, plain string keeps its buffer when cached event is reused
+  std::string StarSystem;
   std::optional<uint64_t> SystemAddress;
-  std::optional<std::string> StarClass;
+  std::string StarClass;
   std::optional<bool> Taxi;
   };
 
@@ -839,7 +993,7 @@ struct body_t
   };
 
 [[nodiscard]]
-auto to_body(events::scan_detailed_scan_t && scan) -> body_t;
+auto to_body(events::scan_detailed_scan_t const & scan) -> body_t;
 
 inline constexpr auto body_body_id_proj = [](body_t const & b) noexcept -> events::body_id_t { return b.body_id; };
 inline constexpr auto body_body_name_proj = [](body_t const & b) noexcept -> std::string_view { return b.name; };
@@ -890,16 +1044,158 @@ struct star_system_t
     }
   };
 
+///\brief parses UTC timestamp in journal format 2026-01-07T10:43:00Z without allocating
+[[nodiscard]]
+constexpr auto parse_utc_timestamp(std::string_view text) noexcept -> std::optional<std::chrono::sys_seconds>
+  {
+  if(text.size() < 20 or text[4] != '-' or text[7] != '-' or text[10] != 'T' or text[13] != ':' or text[16] != ':'
+     or text[19] != 'Z')
+    return std::nullopt;
+  auto const number = [text](std::size_t pos, std::size_t count) noexcept -> int
+  {
+    int value{};
+    for(std::size_t i{pos}; i != pos + count; ++i)
+      {
+      if(text[i] < '0' or text[i] > '9')
+        return -1;
+      value = value * 10 + (text[i] - '0');
+      }
+    return value;
+  };
+  int const y{number(0, 4)};
+  int const m{number(5, 2)};
+  int const d{number(8, 2)};
+  int const hh{number(11, 2)};
+  int const mm{number(14, 2)};
+  int const ss{number(17, 2)};
+  if(y < 0 or m < 0 or d < 0 or hh < 0 or hh > 23 or mm < 0 or mm > 59 or ss < 0 or ss > 60)
+    return std::nullopt;
+  std::chrono::year_month_day const ymd{
+    std::chrono::year{y}, std::chrono::month{static_cast<unsigned>(m)}, std::chrono::day{static_cast<unsigned>(d)}
+  };
+  if(not ymd.ok())
+    return std::nullopt;
+  return std::chrono::sys_days{ymd} + std::chrono::hours{hh} + std::chrono::minutes{mm} + std::chrono::seconds{ss};
+  }
+
+static_assert(
+  parse_utc_timestamp("2026-01-07T10:43:00Z")
+  == std::chrono::sys_days{std::chrono::year{2026} / 1 / 7} + std::chrono::hours{10} + std::chrono::minutes{43}
+);
+static_assert(not parse_utc_timestamp("2026-13-07T10:43:00Z"));
+
+///\brief timestamp and event name found at the beginning of journal line
+struct journal_line_header_t
+  {
+  std::chrono::sys_seconds timestamp;
+  std::string_view event;  ///< view into scanned line
+  };
+
+///\brief finds "timestamp" and "event" values without tokenizing whole line
+///\details game writes both as first keys of every line, nullopt when line has different layout
+[[nodiscard]]
+constexpr auto scan_journal_line_header(std::string_view line) noexcept -> std::optional<journal_line_header_t>
+  {
+  constexpr std::string_view timestamp_key{R"("timestamp":")"};
+  constexpr std::string_view event_key{R"("event":")"};
+  auto const ts_pos{line.find(timestamp_key)};
+  if(ts_pos == std::string_view::npos)
+    return std::nullopt;
+  auto const value_pos{ts_pos + timestamp_key.size()};
+  std::optional<std::chrono::sys_seconds> const timestamp{parse_utc_timestamp(line.substr(value_pos))};
+  if(not timestamp)
+    return std::nullopt;
+  auto const ev_pos{line.find(event_key, value_pos)};
+  if(ev_pos == std::string_view::npos)
+    return std::nullopt;
+  auto const name_begin{ev_pos + event_key.size()};
+  auto const name_end{line.find('"', name_begin)};
+  if(name_end == std::string_view::npos)
+    return std::nullopt;
+  return journal_line_header_t{.timestamp = *timestamp, .event = line.substr(name_begin, name_end - name_begin)};
+  }
+
+static_assert(
+  scan_journal_line_header(R"({ "timestamp":"2026-01-07T10:43:00Z", "event":"Music", "MusicTrack":"Exploration" })")
+    ->event
+  == "Music"
+);
+
+///\brief result of parsing single journal line
+struct parsed_line_t
+  {
+  std::chrono::sys_seconds timestamp;
+  /// empty for valid lines with events that are not processed by tool
+  std::optional<events::event_holder_t> event;
+  };
+
+///\brief buffers reused between parsed lines, steady state parsing of common events does not allocate
+///\details not thread safe, each parsing thread needs its own context
+struct parser_context_t
+  {
+  /// null terminated copy of parsed line, glaze pads it in place for its padded parsing mode
+  std::string buffer;
+  /// one object per event type, cleared before reuse so strings and vectors keep their capacity
+  std::array<std::optional<events::event_holder_t>, std::variant_size_v<events::event_holder_t>> cache;
+  };
+
+///\brief line parsed into event cached in parser_context_t
+struct parsed_event_ref_t
+  {
+  std::chrono::sys_seconds timestamp;
+  /// null for valid lines with events that are not processed, valid until next parse with the same context
+  events::event_holder_t * event;
+  };
+
+///\brief parses journal line into context without touching any other state
+///\returns nullopt for malformed lines
+///\details events not accepted by filter are returned without event and are counted in stats when not null
+[[nodiscard]]
+auto parse_journal_line(
+  parser_context_t & context,
+  std::string_view journal_dir_path,
+  std::string_view input,
+  events::event_filter_t const & filter = events::handled_events,
+  events::event_filter_stats_t * stats = nullptr
+) -> std::optional<parsed_event_ref_t>;
+
+///\brief parses journal line into owned event using thread local context, may be called concurrently
+[[nodiscard]]
+auto parse_journal_line(
+  std::string_view journal_dir_path,
+  std::string_view input,
+  events::event_filter_t const & filter = events::handled_events,
+  events::event_filter_stats_t * stats = nullptr
+) -> std::optional<parsed_line_t>;
+
 struct generic_state_t
   {
   std::string journal_dir_path_;
-
-  generic_state_t(std::string_view journal_dir_path) : journal_dir_path_{journal_dir_path} {}
+  ///\brief timestamp of last successfully parsed journal line
+  std::chrono::sys_seconds last_event_timestamp_{};
+  events::event_filter_t event_filter_;
+  events::event_filter_stats_t filter_stats_;
+  parser_context_t parser_;
+
+  generic_state_t(std::string_view journal_dir_path, events::event_filter_t const & filter = events::handled_events) :
+      journal_dir_path_{journal_dir_path},
+      event_filter_{filter}
+    {
+    }
 
   virtual ~generic_state_t();
 
   auto discovery(std::string_view input) -> void;
-  virtual auto handle(std::chrono::sys_seconds timestamp, events::event_holder_t && event) -> void = 0;
+  ///\brief applies already parsed line, same as discovery for the line it was parsed from
+  auto apply(parsed_line_t && line) -> void;
+  ///\brief processes lines delivered together, begin_chunk/end_chunk surround them
+  auto process_lines(std::span<std::string_view const> lines) -> void;
+
+  ///\brief called before first line of chunk, allows to group side effects of whole chunk
+  virtual auto begin_chunk() -> void {}
+  virtual auto end_chunk() -> void {}
+  ///\brief event may be reused by parser for next line, handlers copy what they keep
+  virtual auto handle(std::chrono::sys_seconds timestamp, events::event_holder_t const & event) -> void = 0;
   };
 
 struct planet_value_info_t
@@ -1,17 +1,200 @@
 #pragma once
 // #define SPDLOG_USE_STD_FORMAT
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <stop_token>
+#include <vector>
+#include <simple_enum/simple_enum.hpp>
 namespace fs = std::filesystem;
 
 using process_callback = std::function<void(std::string_view)>;
+///\brief receives all complete lines available at once, views are valid only during call
+using process_lines_callback = std::function<void(std::span<std::string_view const>)>;
+
+///\brief how tail_file waits for data appended to journal
+enum struct tail_mode_e : uint8_t
+  {
+  /// blocks on inotify IN_MODIFY/IN_CREATE/IN_MOVED_TO, wakes only when journal changes
+  inotify,
+  /// checks journal every 50ms, used as fallback when inotify is not available
+  polling
+  };
+
+consteval auto adl_enum_bounds(tail_mode_e)
+  {
+  using enum tail_mode_e;
+  return simple_enum::adl_info{inotify, polling};
+  }
+
+///\brief counters updated by tailing thread, may be read concurrently
+struct tail_stats_t
+  {
+  std::atomic<uint64_t> wakeups{};
+  std::atomic<uint64_t> lines{};
+  };
+
+///\brief position in journal just past last complete line
+struct journal_position_t
+  {
+  fs::path journal;
+  uint64_t offset{};
+  };
+
+///\brief called after delivered lines with position that is safe to resume from
+using progress_callback = std::function<void(journal_position_t const &)>;
+
+struct tail_options_t
+  {
+  tail_mode_e mode{tail_mode_e::inotify};
+  tail_stats_t * stats{};
+  progress_callback on_progress;
+  ///\brief follow_journals starts from this position instead of beginning of latest journal, when journal exists
+  std::optional<journal_position_t> start;
+  ///\brief called once from tailing thread when no line arrived for idle_timeout since last delivered chunk
+  std::function<void()> on_idle;
+  std::chrono::milliseconds idle_timeout{};
+  };
 
 [[nodiscard]]
 auto find_all_journals(fs::path const & dir) -> std::vector<fs::path>;
 [[nodiscard]]
 auto find_latest_journal(fs::path const & dir) -> std::optional<fs::path>;
-auto tail_file(fs::path const & path, process_callback const & cb, std::stop_token stoken) -> void;
-auto read_file(fs::path const & path, process_callback const & cb) -> void;
+///\brief last write time in seconds since unix epoch, 0 when file does not exist
+[[nodiscard]]
+auto file_mtime_seconds(fs::path const & path) -> int64_t;
+
+///\brief reads whole file and then waits for appended lines until stop is requested
+///\details when inotify can not be initialized falls back to tail_mode_e::polling,
+/// lines read after single wakeup are delivered as one chunk
+auto tail_file(
+  fs::path const & path, process_lines_callback const & cb, std::stop_token stoken, tail_options_t const & options = {}
+) -> void;
+auto tail_file(
+  fs::path const & path, process_callback const & cb, std::stop_token stoken, tail_options_t const & options = {}
+) -> void;
+
+///\brief tails newest journal in dir and switches to newer journals created by game without restart
+///\details remaining tail of previous journal is delivered before the first line of the next one,
+/// when options.start is set all journals from that position up to newest are consumed
+auto follow_journals(
+  fs::path const & dir, process_lines_callback const & cb, std::stop_token stoken, tail_options_t const & options = {}
+) -> void;
+auto follow_journals(
+  fs::path const & dir, process_callback const & cb, std::stop_token stoken, tail_options_t const & options = {}
+) -> void;
+
+///\brief read only memory mapping of whole file, unmapped on destruction
+struct mapped_file_t
+  {
+  char const * data_{};
+  std::size_t size_{};
+
+  mapped_file_t() noexcept = default;
+  mapped_file_t(mapped_file_t const &) = delete;
+  auto operator=(mapped_file_t const &) -> mapped_file_t & = delete;
+  ~mapped_file_t();
+
+  ///\brief maps file with sequential access advice, empty file results in empty view
+  [[nodiscard]]
+  auto open(fs::path const & path) -> bool;
+  auto close() noexcept -> void;
+
+  [[nodiscard]]
+  auto view() const noexcept -> std::string_view
+    {
+    return {data_, size_};
+    }
+  };
+
+///\brief splits content in place, delivered lines are views into content without line terminators
+///\details unterminated last line is delivered only with deliver_partial_tail, otherwise it may be still written
+///\returns number of bytes consumed, position just past last delivered line
+template<typename line_sink>
+constexpr auto for_each_line(std::string_view content, line_sink && sink, bool deliver_partial_tail = false)
+  -> std::size_t
+  {
+  std::size_t consumed{};
+  while(consumed != content.size())
+    {
+    auto eol{content.find('\n', consumed)};
+    if(eol == std::string_view::npos)
+      {
+      if(not deliver_partial_tail)
+        return consumed;
+      eol = content.size();
+      }
+    std::string_view line{content.substr(consumed, eol - consumed)};
+    consumed = eol == content.size() ? eol : eol + 1;
+    if(line.ends_with('\r'))
+      line.remove_suffix(1);
+    if(not line.empty())
+      sink(line);
+    }
+  return consumed;
+  }
+
+///\brief bulk reader delivering lines in chunks of at most chunk_lines views into memory mapped file
+///\details sink is called with std::span<std::string_view const> and is inlined, sink accepting also uint64_t
+/// receives file offset just past last line of chunk, deliver_partial_tail is for files not written anymore
+///\returns offset just past last delivered line, start_offset when file can not be opened
+template<typename lines_sink>
+auto read_file_chunks(
+  fs::path const & path,
+  lines_sink && sink,
+  uint64_t start_offset = 0,
+  bool deliver_partial_tail = false,
+  std::size_t chunk_lines = 4096
+) -> uint64_t
+  {
+  mapped_file_t mapped;
+  if(not mapped.open(path))
+    return start_offset;
+  std::string_view content{mapped.view()};
+  if(start_offset >= content.size())
+    return start_offset;
+  content.remove_prefix(start_offset);
+
+  std::vector<std::string_view> lines;
+  lines.reserve(chunk_lines);
+  auto const deliver = [&](std::string_view line)
+  {
+    // terminator of line follows its view, possibly after stripped carriage return, unterminated tail ends content
+    std::size_t const line_end{static_cast<std::size_t>(line.data() + line.size() - content.data())};
+    std::size_t const eol{content.find('\n', line_end)};
+    uint64_t const chunk_end{start_offset + (eol == std::string_view::npos ? content.size() : eol + 1)};
+    if constexpr(std::invocable<lines_sink &, std::span<std::string_view const>, uint64_t>)
+      sink(std::span<std::string_view const>{lines}, chunk_end);
+    else
+      sink(std::span<std::string_view const>{lines});
+    lines.clear();
+  };
+  std::size_t const consumed{for_each_line(
+    content,
+    [&](std::string_view line)
+    {
+      lines.emplace_back(line);
+      if(lines.size() == chunk_lines)
+        deliver(line);
+    },
+    deliver_partial_tail
+  )};
+  if(not lines.empty())
+    deliver(lines.back());
+  return start_offset + consumed;
+  }
 
+///\brief bulk reader for historical journals, lines are delivered as views into memory mapped file
+///\details unterminated last line is delivered too unless deliver_partial_tail is false as file may be still written
+///\returns offset just past last delivered line, reading may be resumed from it
+auto read_file(
+  fs::path const & path, process_callback const & cb, uint64_t start_offset = 0, bool deliver_partial_tail = true
+) -> uint64_t;
+///\brief std::ifstream based reader, each line is copied into std::string
+auto read_file_stream(fs::path const & path, process_callback const & cb) -> void;
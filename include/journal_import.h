@@ -0,0 +1,36 @@
+#pragma once
+#include <elite_events.h>
+#include <file_io.h>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+///\brief journal to import from start_offset up to last complete line
+struct journal_import_task_t
+  {
+  fs::path journal;
+  uint64_t start_offset{};
+  ///\brief game does not write to journal anymore, unterminated last line is imported too
+  bool complete{};
+  };
+
+struct journal_import_callbacks_t
+  {
+  ///\brief called by sequencer before first event of journal is applied
+  std::function<void(journal_import_task_t const &)> on_journal_begin;
+  ///\brief called by sequencer between chunks of journal, end_offset is past last line of applied chunk
+  std::function<void(journal_import_task_t const &, uint64_t end_offset)> on_chunk_end;
+  ///\brief called by sequencer after last event of journal was applied, end_offset is past last imported line
+  std::function<void(journal_import_task_t const &, uint64_t end_offset)> on_journal_end;
+  };
+
+///\brief imports journals applying events to state in order of tasks
+///\details with jobs > 1 journals are parsed by pool of threads into batches of typed events while calling
+/// thread applies finished batches in task order, so state and all callbacks are used only from calling thread.
+/// At most 2*jobs parsed journals are kept in memory waiting for sequencer.
+auto import_journals(
+  std::span<journal_import_task_t const> tasks,
+  generic_state_t & state,
+  uint32_t jobs,
+  journal_import_callbacks_t const & callbacks = {}
+) -> void;
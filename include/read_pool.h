@@ -0,0 +1,65 @@
+#pragma once
+#include <databse_storage.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+///\brief read only connections running queries on own threads concurrently with storage thread writes
+///\details each thread owns one connection, tasks see writes committed before they start and never block writer as
+/// database is in write ahead log mode, tasks not started yet are dropped on destruction
+struct read_pool_t
+  {
+  using task_t = std::function<void(database_storage_t &)>;
+
+  std::mutex mtx_;
+  std::condition_variable_any not_empty_;
+  std::deque<task_t> tasks_;
+  std::vector<std::unique_ptr<database_storage_t>> connections_;
+  std::vector<std::jthread> workers_;
+
+  read_pool_t() = default;
+  read_pool_t(read_pool_t const &) = delete;
+  auto operator=(read_pool_t const &) -> read_pool_t & = delete;
+  ~read_pool_t();
+
+  ///\brief opens connections to database already opened by writer and starts one thread per connection
+  [[nodiscard]]
+  auto open(std::string_view db_path, std::size_t connections) -> expected_ec<void>;
+
+  [[nodiscard]]
+  auto is_open() const noexcept -> bool
+    {
+    return not workers_.empty();
+    }
+
+  ///\brief queues task to be run by first idle connection
+  auto push(task_t task) -> void;
+
+  ///\brief runs fn on one of connections and waits for its result
+  ///\details fn has to return expected_ec, not_connected is returned without running fn when pool is not open, must
+  /// not be called when pool may be destroyed before fn starts
+  template<typename fn_t>
+  auto call(fn_t && fn) -> std::invoke_result_t<fn_t &, database_storage_t &>
+    {
+    using result_t = std::invoke_result_t<fn_t &, database_storage_t &>;
+    // no worker would ever take task
+    if(not is_open()) [[unlikely]]
+      return result_t{cxx23::unexpected(std::make_error_code(std::errc::not_connected))};
+    std::packaged_task<result_t(database_storage_t &)> task{std::forward<fn_t>(fn)};
+    std::future<result_t> result{task.get_future()};
+    push([&task](database_storage_t & db) { task(db); });
+    return result.get();
+    }
+
+private:
+  auto run(std::stop_token stoken, database_storage_t & db) -> void;
+  };
@@ -0,0 +1,77 @@
+#pragma once
+#include <databse_storage.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+///\brief counters updated by storage thread, may be read concurrently
+struct storage_queue_stats_t
+  {
+  std::atomic<uint64_t> applied{};
+  std::atomic<uint64_t> batches{};
+  ///\brief pushes that waited because queue was full
+  std::atomic<uint64_t> stalls{};
+  };
+
+///\brief write-behind queue applying database tasks in order on dedicated storage thread
+///\details once queue is created database must be accessed only through its tasks, tasks taken at single wakeup are
+/// applied inside one transaction, push blocks while capacity tasks are waiting, pending tasks are applied on destruction,
+/// write ahead log is checkpointed after batch once it reaches checkpoint_pages_
+struct storage_queue_t
+  {
+  using task_t = std::function<void(database_storage_t &)>;
+
+  database_storage_t & db_;
+  std::size_t capacity_;
+  uint32_t checkpoint_pages_{1000};
+  std::mutex mtx_;
+  std::condition_variable_any not_empty_;
+  std::condition_variable not_full_;
+  std::condition_variable drained_;
+  std::deque<task_t> tasks_;
+  ///\brief callbacks registered by tasks of current batch, used only by storage thread
+  std::vector<std::function<void()>> after_commit_;
+  ///\brief storage thread applies batch taken from tasks_
+  bool busy_{};
+  storage_queue_stats_t stats_;
+  std::jthread worker_;
+
+  explicit storage_queue_t(database_storage_t & db, std::size_t capacity = 1024);
+  storage_queue_t(storage_queue_t const &) = delete;
+  auto operator=(storage_queue_t const &) -> storage_queue_t & = delete;
+  ~storage_queue_t();
+
+  ///\brief queues task after all already queued ones, blocks while queue is full
+  auto push(task_t task) -> void;
+
+  ///\brief waits until all tasks queued so far are applied
+  auto flush() -> void;
+
+  ///\brief runs fn on storage thread once transaction of current batch ends
+  ///\details must be called only from task, lets other connections observe everything written before it
+  auto after_commit(std::function<void()> fn) -> void;
+
+  ///\brief runs fn on storage thread after queued tasks and waits for its result
+  ///\details must not be called from task as storage thread would wait for itself
+  template<typename fn_t>
+  auto call(fn_t && fn) -> std::invoke_result_t<fn_t &, database_storage_t &>
+    {
+    using result_t = std::invoke_result_t<fn_t &, database_storage_t &>;
+    std::packaged_task<result_t(database_storage_t &)> task{std::forward<fn_t>(fn)};
+    std::future<result_t> result{task.get_future()};
+    push([&task](database_storage_t & db) { task(db); });
+    return result.get();
+    }
+
+private:
+  auto run(std::stop_token stoken) -> void;
+  };
@@ -13,50 +13,31 @@ void critical_abort(std::format_string<Args...> fmt, Args &&... args)
   std::abort();
   }
 
-void process_factions(database_storage_t & db, std::span<events::faction_info_t> factions)
+void process_factions(database_storage_t & db, std::span<events::faction_info_t const> factions)
   {
-  for(events::faction_info_t & f: factions)
-    {
-    info::faction_info_t new_faction_data{info::to_native(std::move(f))};
-    auto res{db.load_faction(new_faction_data.name)};
-    if(not res)
-      critical_abort("failed to load cation info for {}", new_faction_data.name);
-    if(not *res)
-      {
-      // no data add
-      spdlog::info("adding faction {}", new_faction_data.name);
-      if(auto updres{db.update_faction_info(new_faction_data)}; not updres)
-        critical_abort("failed to add faction data for {}", new_faction_data.name);
-      }
-    else
-      {
-      info::faction_info_t old_faction_data{std::move(**res)};
-      if(old_faction_data != new_faction_data)
-        {
-        new_faction_data.oid = old_faction_data.oid;
-        spdlog::info("updating faction {}", new_faction_data.name);
-        if(auto updres{db.update_faction_info(new_faction_data)}; not updres)
-          critical_abort("failed to update faction data for {}", new_faction_data.name);
-        }
-      }
-    }
+  std::vector<info::faction_info_t> native;
+  native.reserve(factions.size());
+  for(events::faction_info_t const & f: factions)
+    native.emplace_back(info::to_native(f));
+  if(auto res{db.sync_factions(native)}; not res)
+    critical_abort("failed to store {} factions {}", native.size(), res.error().message());
   }
   }  // namespace
 
-void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events::event_holder_t && e)
+void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events::event_holder_t const & e)
   {
   state_t & state{*this->state};
   std::visit(
-    [&state]<typename T>(T & event)
+    [&state]<typename T>(T const & event)
     {
       if constexpr(std::same_as<T, events::start_jump_t>)
         {
         if(event.JumpType == events::jump_type_e::Hyperspace)
           {
-          spdlog::info("jump to [{}] {}", *event.StarClass, *event.StarSystem);
+          spdlog::info("jump to [{}] {}", event.StarClass, event.StarSystem);
           auto res{state.db_.load_system(*event.SystemAddress)};
           if(not res) [[unlikely]]
-            critical_abort("error loading system {} {}", *event.SystemAddress, *event.StarSystem);
+            critical_abort("error loading system {} {}", *event.SystemAddress, event.StarSystem);
 
           std::optional loaded{std::move(*res)};
           if(loaded)
@@ -70,15 +51,15 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
             {
             state.system = star_system_t{
               .system_address = *event.SystemAddress,
-              .name = *event.StarSystem,
-              .star_type = *event.StarClass,
+              .name = event.StarSystem,
+              .star_type = event.StarClass,
               .system_location = {},
               .bary_centre = {},
               .bodies = {},
               .fss_complete = {}
             };
             if(auto res2{state.db_.store(state.system)}; not res2) [[unlikely]]
-              critical_abort("error string system {} {}", *event.SystemAddress, *event.StarSystem);
+              critical_abort("error string system {} {}", *event.SystemAddress, event.StarSystem);
             }
           }
         }
@@ -148,7 +129,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
           return;
           }
 
-        state.system.bodies.emplace_back(to_body(std::move(event)));
+        state.system.bodies.emplace_back(to_body(event));
         body_t & body{state.system.bodies.back()};
         body.value = exploration::aprox_value(body);
 
@@ -185,7 +166,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
           body.details
         );
 
-        if(auto res{state.db_.store(state.system.system_address, body)}; not res)
+        if(auto res{state.db_.store(state.system.system_address, state.system.name, body)}; not res)
           critical_abort("failed to store body {}: {}", state.system.system_address, body.name);
 
         // handle rings
@@ -195,7 +176,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
           std::ranges::transform(
             event.Rings,
             std::back_inserter(rings),
-            [&event](events::ring_t & ring) -> ring_t
+            [&event](events::ring_t const & ring) -> ring_t
             {
               return ring_t{
                 .name = std::string(stralgo::right(ring.Name, 6)),
@@ -242,7 +223,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
         if(it != state.system.bodies.end())
           {
           planet_details_t & details{std::get<planet_details_t>(it->details)};
-          details.signals_ = std::move(event.Signals);
+          details.signals_ = event.Signals;
 
           if(auto res{state.db_.store(state.system.system_address, event.BodyID, details.signals_)}; not res)
             critical_abort("failed to store signals for {}: {}", state.system.system_address, event.BodyID);
@@ -250,7 +231,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
         else
           {
           spdlog::info("buffering signals for {}: {}", state.system.system_address, event.BodyID);
-          state.buffered_signals.emplace_back(event.BodyID, std::move(event.Signals));
+          state.buffered_signals.emplace_back(event.BodyID, event.Signals);
           }
         }
       else if constexpr(std::same_as<T, events::dss_body_signals_t>)
@@ -260,7 +241,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
           if(auto it{state.system.ring_by_id(event.BodyID)}; it != state.system.rings.end())
             {
             ring_t & ring{*it};
-            ring.signals_ = std::move(event.Signals);
+            ring.signals_ = event.Signals;
             if(auto res{state.db_.store(state.system.system_address, event.BodyID, ring.signals_)}; not res)
               critical_abort("failed to store signals for ring {}: {}", state.system.system_address, event.BodyID);
             }
@@ -274,13 +255,13 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
           planet_details_t & details{std::get<planet_details_t>(it->details)};
           if(details.signals_.size() != event.Signals.size())
             {
-            details.signals_ = std::move(event.Signals);
+            details.signals_ = event.Signals;
             if(auto res{state.db_.store(state.system.system_address, event.BodyID, details.signals_)}; not res)
               critical_abort("failed to store signals for {}: {}", state.system.system_address, event.BodyID);
             }
           if(details.genuses_.size() != event.Genuses.size())
             {
-            details.genuses_ = std::move(event.Genuses);
+            details.genuses_ = event.Genuses;
             if(auto res{state.db_.store(state.system.system_address, event.BodyID, details.genuses_)}; not res)
               critical_abort("failed to store genuses_ for {}: {}", state.system.system_address, event.BodyID);
             }
@@ -288,7 +269,7 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
         else
           {
           spdlog::info("buffering signals for {}: {}", state.system.system_address, event.BodyID);
-          state.buffered_signals.emplace_back(event.BodyID, std::move(event.Signals), std::move(event.Genuses));
+          state.buffered_signals.emplace_back(event.BodyID, event.Signals, event.Genuses);
           }
         }
       else if constexpr(std::same_as<T, events::fss_all_bodies_found_t>)
@@ -414,4 +395,28 @@ void database_import_state_t::handle(std::chrono::sys_seconds timestamp, events:
     },
     e
   );
+
+  ++uncommitted_events_;
+  }
+
+void database_import_state_t::begin_chunk()
+  {
+  if(auto res{state->db_.begin_transaction()}; not res) [[unlikely]]
+    critical_abort("failed to begin transaction");
+  }
+
+void database_import_state_t::end_chunk()
+  {
+  if(auto res{state->db_.commit_transaction()}; not res) [[unlikely]]
+    critical_abort("failed to commit imported events");
+  }
+
+auto database_import_state_t::commit_progress(journal_checkpoint_t const & checkpoint) -> expected_ec<void>
+  {
+  if(commit_every_ == 0 or uncommitted_events_ < commit_every_ or not state->db_.in_transaction())
+    return {};
+  uncommitted_events_ = 0;
+  if(auto res{state->db_.store(checkpoint)}; not res) [[unlikely]]
+    return res;
+  return state->db_.commit_pending();
   }
@@ -1,7 +1,13 @@
 // #define SPDLOG_USE_STD_FORMAT
 #include <databse_storage.h>
 #include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
 #include <glaze/glaze.hpp>
 #include <elite_events.h>
 #include <spdlog/spdlog.h>
@@ -375,6 +381,14 @@ auto to_native_fromat(sql_iface::star_system_t && system) noexcept -> ::star_sys
 namespace tables
   {
   inline constexpr std::string_view star_system{"star_system"};
+  ///\brief rtree virtual table indexing star_system location, id is system_address
+  inline constexpr std::string_view star_system_location{"star_system_location"};
+  ///\brief fts5 unicode61 index of system, body, faction and mission destination names for word prefix search
+  inline constexpr std::string_view name_search{"name_search"};
+  ///\brief fts5 trigram index of the same names with the same rowid for fuzzy search
+  inline constexpr std::string_view name_trigram{"name_trigram"};
+  ///\brief rowid of full text index entries keyed by name_kind_e and id of named record
+  inline constexpr std::string_view name_entry{"name_entry"};
   inline constexpr std::string_view bary_centre{"bary_centre"};
   inline constexpr std::string_view star_details{"star_details"};
   inline constexpr std::string_view atmosphere_element{"atmosphere_element"};
@@ -385,11 +399,121 @@ namespace tables
   inline constexpr std::string_view planet_details{"planet_details"};
   inline constexpr std::string_view faction_info{"faction_info"};
   inline constexpr std::string_view mission{"mission"};
+  inline constexpr std::string_view journal_checkpoint{"journal_checkpoint"};
   }  // namespace tables
+
+///\brief secondary index of table, unused trailing columns are empty
+struct index_def_t
+  {
+  std::string_view name;
+  std::string_view table;
+  std::array<std::string_view, 4> columns;
+  bool unique;
+  };
+
+///\brief declares index on table storing table_type, columns are verified against reflected fields at compile time
+template<typename table_type>
+consteval auto index_on(
+  std::string_view table, std::string_view name, std::initializer_list<std::string_view> columns, bool unique = false
+) -> index_def_t
+  {
+  index_def_t result{.name = name, .table = table, .columns = {}, .unique = unique};
+  if(columns.size() == 0 or columns.size() > result.columns.size())
+    throw "index must have from 1 to 4 columns";
+  std::size_t ix{};
+  for(std::string_view column: columns)
+    {
+    if(std::ranges::find(glz::reflect<table_type>::keys, column) == glz::reflect<table_type>::keys.end())
+      throw "index column is not a field of table";
+    result.columns[ix++] = column;
+    }
+  return result;
+  }
+
+///\brief indexes of hot lookups, created by create_database and migration to version 2
+inline constexpr std::array indexes{
+  index_on<body_t>(tables::body, "body_system_body_id", {"ref_system_address", "body_id"}),
+  index_on<bary_centre_t>(tables::bary_centre, "bary_centre_system", {"ref_system_address"}),
+  index_on<planet_details_t>(tables::planet_details, "planet_details_body", {"ref_body_oid"}),
+  index_on<star_details_t>(tables::star_details, "star_details_body", {"ref_body_oid"}),
+  index_on<signal_t>(tables::signal, "signal_body", {"ref_body_oid"}),
+  index_on<genus_t>(tables::genus, "genus_body", {"ref_body_oid"}),
+  index_on<atmosphere_element_t>(tables::atmosphere_element, "atmosphere_element_body", {"ref_body_oid"}),
+  index_on<ring_t>(tables::ring, "ring_system_parent", {"ref_system_address", "parent_body_id"}),
+  index_on<info::faction_info_t>(tables::faction_info, "faction_info_name", {"name"}, true),
+  index_on<info::mission_t>(tables::mission, "mission_status_expiry", {"status", "expiry"})
+};
+
+/// PRAGMA user_version of database created by current code
+///  1 - journal_checkpoint
+///  2 - secondary indexes, duplicated faction_info names removed
+///  3 - timestamps as INTEGER seconds since epoch and enums as INTEGER ordinals instead of TEXT
+///  4 - star_system_location rtree spatial index
+///  5 - name_search and name_trigram full text indexes
+///  6 - name_entry keys of full text index entries, indexes rebuilt
+inline constexpr uint32_t schema_version{6};
   };  // namespace sql_iface
 
 using namespace std::string_view_literals;
 
+struct sqlite3_handle_t
+  {
+  struct statement_deleter_t
+    {
+    auto operator()(sqlite3_stmt * stmt) const noexcept -> void { sqlite3_finalize(stmt); }
+    };
+
+  using statement_ptr = std::unique_ptr<sqlite3_stmt, statement_deleter_t>;
+
+  struct sql_hash_t
+    {
+    using is_transparent = void;
+
+    auto operator()(std::string_view sql) const noexcept -> std::size_t { return std::hash<std::string_view>{}(sql); }
+    };
+
+  sqlite3 * db{};
+  ///\brief statements prepared once per connection with SQLITE_PREPARE_PERSISTENT, keyed by sql text
+  std::unordered_map<std::string, statement_ptr, sql_hash_t, std::equal_to<>> statements;
+
+  sqlite3_handle_t() noexcept = default;
+  sqlite3_handle_t(sqlite3_handle_t &&) noexcept = delete;
+  auto operator=(sqlite3_handle_t &&) noexcept -> sqlite3_handle_t & = delete;
+
+  ///\brief returns cached statement for query preparing it on first use, nullptr on error
+  [[nodiscard]]
+  auto prepare(std::string_view query) -> sqlite3_stmt *
+    {
+    if(auto it{statements.find(query)}; it != statements.end()) [[likely]]
+      return it->second.get();
+
+    sqlite3_stmt * stmt{};
+    int const rc{sqlite3_prepare_v3(
+      db, query.data(), static_cast<int>(query.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr
+    )};
+    if(rc != SQLITE_OK) [[unlikely]]
+      {
+      spdlog::error("[sql] {} {}", query, sqlite3_errmsg(db));
+      sqlite3_finalize(stmt);
+      return nullptr;
+      }
+    spdlog::debug("[sql] prepared {}", query);
+    return statements.emplace(std::string{query}, statement_ptr{stmt}).first->second.get();
+    }
+
+  void close()
+    {
+    statements.clear();
+    if(db)
+      {
+      sqlite3_close(db);
+      db = nullptr;
+      }
+    }
+
+  ~sqlite3_handle_t() { close(); }
+  };
+
 namespace sqlite
   {
 namespace details
@@ -414,9 +538,9 @@ constexpr auto reflection_type_name() -> std::string_view
   if constexpr(is_optional<T>)
     return reflection_type_name<typename T::value_type>();
   else if constexpr(std::same_as<T, std::chrono::sys_seconds>)
-    return "TEXT"sv;
+    return "INTEGER"sv;  // seconds since epoch
   else if constexpr(simple_enum::bounded_enum<T>)
-    return "TEXT"sv;
+    return "INTEGER"sv;  // ordinal
   else if constexpr(std::integral<T>)
     return "INTEGER"sv;
   else if constexpr(std::floating_point<T>)
@@ -427,74 +551,121 @@ constexpr auto reflection_type_name() -> std::string_view
     static_assert(false);
   }
 
-[[nodiscard]]
-constexpr auto escape_sql_quotes(std::string_view const value) -> std::string
-  {
-  auto const extra_space = std::ranges::count(value, '\'');
-  if(extra_space == 0) [[likely]]
-    return std::string{value};
-
-  std::string result;
-  auto const max_size = value.size() + extra_space;
-  result.resize_and_overwrite(
-    max_size,
-    [value](char * buf, std::size_t buf_size) noexcept -> std::size_t
-    {
-      auto * out = buf;
-      for(char const c: value)
-        if(c == '\'') [[unlikely]]
-          {
-          *out++ = '\'';
-          *out++ = '\'';
-          }
-        else
-          *out++ = c;
-      return static_cast<std::size_t>(out - buf);
-    }
-  );
-
-  return result;
-  }
-
-static_assert("''b''s''"sv == escape_sql_quotes("'b's'"));
-
+///\brief binds value to 1 based parameter index
+///\details text is bound with SQLITE_STATIC, it must stay alive until statement_scope_t clears bindings
 template<typename T>
-constexpr auto serialize(T const & value) -> std::string
+auto bind(sqlite3_stmt * stmt, int ix, T const & value) -> int
   {
   if constexpr(is_optional<T>)
+    {
     if(not value)
-      return std::string{"NULL"};
-    else
-      return serialize(*value);
+      return sqlite3_bind_null(stmt, ix);
+    return bind(stmt, ix, *value);
+    }
   else if constexpr(std::same_as<T, std::chrono::sys_seconds>)
-    return std::format("{:%Y-%m-%dT%H:%M:%SZ}", value);
+    return sqlite3_bind_int64(stmt, ix, static_cast<sqlite3_int64>(value.time_since_epoch().count()));
   else if constexpr(simple_enum::bounded_enum<T>)
-    return std::string(simple_enum::enum_name(value));
+    return sqlite3_bind_int64(stmt, ix, static_cast<sqlite3_int64>(std::to_underlying(value)));
   else if constexpr(std::same_as<T, bool>)
+    return sqlite3_bind_int(stmt, ix, value ? 1 : 0);
+  else if constexpr(std::integral<T>)
+    return sqlite3_bind_int64(stmt, ix, static_cast<sqlite3_int64>(value));
+  else if constexpr(std::floating_point<T>)
+    return sqlite3_bind_double(stmt, ix, static_cast<double>(value));
+  else if constexpr(std::convertible_to<T const &, std::string_view>)
     {
-    return value ? "1" : "0";
+    std::string_view const text{value};
+    return sqlite3_bind_text(stmt, ix, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
     }
-  else if constexpr(std::integral<T>)
+  else
+    static_assert(false);
+  }
+
+template<typename... args_t>
+auto bind_all(sqlite3_stmt * stmt, args_t const &... args) -> int
+  {
+  [[maybe_unused]]
+  int ix{};
+  int rc{SQLITE_OK};
+  ((rc = rc == SQLITE_OK ? bind(stmt, ++ix, args) : rc), ...);
+  return rc;
+  }
+
+///\brief resets cached statement and releases bound values when leaving scope
+struct statement_scope_t
+  {
+  sqlite3_stmt * stmt;
+
+  ~statement_scope_t()
     {
-    std::array<char, 25> buffer{};  // Large enough for 64-bit integers
-    auto [ptr, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    }
+  };
+
+[[nodiscard]]
+static auto report_error(sqlite3_handle_t const & h, std::string_view query) -> cxx23::unexpected<std::error_code>
+  {
+  spdlog::error("[sql] {} {}", query, sqlite3_errmsg(h.db));
+  return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  }
+
+///\brief steps statement that does not return rows
+[[nodiscard]]
+static auto step_done(sqlite3_handle_t const & h, sqlite3_stmt * stmt, std::string_view query) -> expected_ec<void>
+  {
+  if(sqlite3_step(stmt) != SQLITE_DONE) [[unlikely]]
+    return report_error(h, query);
+  return {};
+  }
+
+///\brief column of current row as text, empty for SQL NULL
+[[nodiscard]]
+inline auto column_text(sqlite3_stmt * stmt, int ix) noexcept -> std::string_view
+  {
+  unsigned char const * text{sqlite3_column_text(stmt, ix)};
+  if(text == nullptr)
+    return {};
+  return {reinterpret_cast<char const *>(text), static_cast<std::size_t>(sqlite3_column_bytes(stmt, ix))};
+  }
 
-    if(ec != std::errc{})
-      return "0";  // Logical error: fallback for failed conversion
-    return std::string(buffer.data(), ptr);
+///\brief reads column of current row with sqlite3_column_* accessor matching reflected field type
+template<typename T>
+auto read_column(sqlite3_stmt * stmt, int ix) -> T
+  {
+  if constexpr(is_optional<T>)
+    {
+    int const type{sqlite3_column_type(stmt, ix)};
+    // older versions stored missing values as 'NULL' text
+    if(type == SQLITE_NULL or (type == SQLITE_TEXT and column_text(stmt, ix) == "NULL"sv))
+      return T{};
+    return T{read_column<typename T::value_type>(stmt, ix)};
     }
-  else if constexpr(std::floating_point<T>)
+  else if constexpr(std::same_as<T, std::chrono::sys_seconds>)
     {
-    std::array<char, 64> buffer{};
-    auto [ptr, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
-    if(ec != std::errc{})
-      return "0.0";
-    return std::string(buffer.data(), ptr);
+    // ISO-8601 text is found only in tables of schema older than version 3
+    if(sqlite3_column_type(stmt, ix) == SQLITE_TEXT) [[unlikely]]
+      return parse_utc_timestamp(column_text(stmt, ix)).value_or(std::chrono::sys_seconds{});
+    return std::chrono::sys_seconds{std::chrono::seconds{sqlite3_column_int64(stmt, ix)}};
     }
-  else if constexpr(std::same_as<T, std::string> or std::same_as<T, std::string_view>)
+  else if constexpr(simple_enum::bounded_enum<T>)
     {
-    return escape_sql_quotes(value);
+    // enum names are found only in tables of schema older than version 3
+    if(sqlite3_column_type(stmt, ix) == SQLITE_TEXT) [[unlikely]]
+      {
+      auto const res{simple_enum::enum_cast<T>(column_text(stmt, ix))};
+      return res ? *res : T{};
+      }
+    return static_cast<T>(sqlite3_column_int64(stmt, ix));
     }
+  else if constexpr(std::same_as<T, bool>)
+    return sqlite3_column_int(stmt, ix) != 0;
+  else if constexpr(std::integral<T>)
+    return static_cast<T>(sqlite3_column_int64(stmt, ix));
+  else if constexpr(std::floating_point<T>)
+    return static_cast<T>(sqlite3_column_double(stmt, ix));
+  else if constexpr(std::same_as<T, std::string>)
+    return std::string{column_text(stmt, ix)};
   else
     static_assert(false);
   }
@@ -533,227 +704,272 @@ static auto create_table(sqlite3 * db, std::string_view const pk, std::string_vi
   return {};
   }
 
-template<typename table_type, bool with_pk_store = false>
-static auto insert_into(sqlite3 * db, std::string_view const pk, std::string_view name, table_type const & record)
-  -> expected_ec<void>
+template<typename table_type, bool with_pk_store, bool or_replace>
+auto insert_sql(std::string_view const pk, std::string_view name) -> std::string
   {
-  std::string query{std::format("INSERT INTO {} (", name)};
-  // (name) VALUES ('{}');
-  uint32_t ix{};
-  glz::for_each_field(
-    record,
-    [&query, &ix, &pk]<typename T>(T &)
-    {
-      auto const key{glz::reflect<table_type>::keys[ix]};
-      if constexpr(with_pk_store)
-        query.append(std::format("{},", key));
-      else if(key != pk)
-        query.append(std::format("{},", key));
-      ++ix;
-    }
-  );
-  query.pop_back();  // drop ,
-  query.append(") VALUES (");
-  ix = 0;
-  glz::for_each_field(
-    record,
-    [&query, &ix, &pk]<typename T>(T & value)
-    {
-      auto const key{glz::reflect<table_type>::keys[ix]};
-      if constexpr(with_pk_store)
-        query.append(std::format("'{}',", serialize(value)));
-      else if(key != pk)
-        query.append(std::format("'{}',", serialize(value)));
-      ++ix;
-    }
-  );
+  std::string columns;
+  std::string values;
+  for(std::string_view const key: glz::reflect<table_type>::keys)
+    if(with_pk_store or key != pk)
+      {
+      columns.append(std::format("{},", key));
+      values.append("?,");
+      }
+  columns.pop_back();  // drop ,
+  values.pop_back();
+  return std::format("INSERT {}INTO {} ({}) VALUES ({})", or_replace ? "OR REPLACE "sv : ""sv, name, columns, values);
+  }
+
+template<typename table_type>
+auto update_pk_sql(std::string_view const pk, std::string_view name) -> std::string
+  {
+  std::string query{std::format("UPDATE {} SET ", name)};
+  for(std::string_view const key: glz::reflect<table_type>::keys)
+    if(key != pk)
+      query.append(std::format("{}=?,", key));
   query.pop_back();  // drop ,
-  query.append(");");
+  query.append(std::format(" WHERE {}=?", pk));
+  return query;
+  }
 
-  char * err_msg = nullptr;
-  int const rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &err_msg);
+///\brief INSERT of all columns except pk, existing row with the same conflict_key value is updated instead
+///\details conflict_key has to be covered by unique index, pk of inserted or updated row is returned
+template<typename table_type>
+auto upsert_sql(std::string_view const pk, std::string_view name, std::string_view conflict_key) -> std::string
+  {
+  std::string query{insert_sql<table_type, false, false>(pk, name)};
+  query.append(std::format(" ON CONFLICT({}) DO UPDATE SET ", conflict_key));
+  for(std::string_view const key: glz::reflect<table_type>::keys)
+    if(key != pk and key != conflict_key)
+      query.append(std::format("{0}=excluded.{0},", key));
+  query.pop_back();  // drop ,
+  query.append(std::format(" RETURNING {}", pk));
+  return query;
+  }
 
-  if(rc != SQLITE_OK)
-    {
-    spdlog::error("[sql] {} {}", query, err_msg);
-    sqlite3_free(err_msg);
-    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
-    }
-  spdlog::debug("[sql] {}", query);
-  return {};
+///\brief SELECT of all reflected columns, where_clause may contain ? parameters bound by select_rows
+template<typename table_type>
+auto select_sql(std::string_view name, std::string_view where_clause) -> std::string
+  {
+  std::string query{"SELECT "};
+  for(std::string_view const key: glz::reflect<table_type>::keys)
+    query.append(std::format("{},", key));
+  query.pop_back();  // drop ,
+  query.append(std::format(" FROM {} {}", name, where_clause));
+  return query;
   }
 
-template<typename table_type, typename pk_type>
-static auto update_pk(
-  sqlite3 * db, std::string_view const pk, std::string_view name, table_type const & record, pk_type const & pk_value
+///\brief inserts record with cached statement
+///\details each row type is stored in exactly one table so statement text is generated once per instantiation
+template<typename table_type, bool with_pk_store = false, bool or_replace = false>
+static auto insert_into(
+  sqlite3_handle_t & h, std::string_view const pk, std::string_view name, table_type const & record
 ) -> expected_ec<void>
   {
-  std::string query{std::format("UPDATE {} SET ", name)};
-  uint32_t ix{};
+  static std::string const query{insert_sql<table_type, with_pk_store, or_replace>(pk, name)};
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+
+  int rc{SQLITE_OK};
+  int bind_ix{};
+  std::size_t ix{};
   glz::for_each_field(
     record,
-    [&query, &ix, &pk]<typename T>(T & value)
+    [&]<typename T>(T & value)
     {
-      auto const key{glz::reflect<table_type>::keys[ix]};
-      if(key != pk)
-        query.append(std::format("{}='{}',", key, serialize(value)));
+      if(rc == SQLITE_OK and (with_pk_store or glz::reflect<table_type>::keys[ix] != pk))
+        rc = bind(stmt, ++bind_ix, value);
       ++ix;
     }
   );
-  query.pop_back();  // drop ,
-  query.append(std::format(" WHERE {}='{}'", pk, serialize(pk_value)));
-
-  char * err_msg = nullptr;
-  int const rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &err_msg);
-
-  if(rc != SQLITE_OK)
-    {
-    spdlog::error("[sql] {} {}", query, err_msg);
-    sqlite3_free(err_msg);
-    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
-    }
-  spdlog::debug("[sql] {}", query);
-  return {};
+  if(rc != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
+  return step_done(h, stmt, query);
   }
 
-template<typename T>
-constexpr auto deserialize(std::string_view const value) -> T
+template<typename table_type, typename pk_type>
+static auto update_pk(
+  sqlite3_handle_t & h,
+  std::string_view const pk,
+  std::string_view name,
+  table_type const & record,
+  pk_type const & pk_value
+) -> expected_ec<void>
   {
-  if constexpr(is_optional<T>)
-    if("NULL"sv == value)
-      return T{};
-    else
-      return deserialize<typename T::value_type>(value);
-  else if constexpr(std::same_as<T, std::chrono::sys_seconds>)
-    {
-    using namespace std::string_literals;
-    std::chrono::sys_seconds tp;
-    std::stringstream ss{std::string{value}};
-
-    ss >> std::chrono::parse("%Y-%m-%dT%H:%M:%SZ"s, tp);
-
-    if(ss.fail())
-      return std::chrono::sys_seconds{std::chrono::seconds{0}};
+  static std::string const query{update_pk_sql<table_type>(pk, name)};
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
 
-    return tp;
-    }
-  else if constexpr(simple_enum::bounded_enum<T>)
-    {
-    auto res{simple_enum::enum_cast<T>(value)};
-    if(res)
-      return *res;
-    return T{};
-    }
-  else if constexpr(std::same_as<T, bool>)
-    {
-    return value == "1"sv;
-    }
-  else if constexpr(std::integral<T>)
-    {
-    T result{};
-    auto const [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
-    if(ec != std::errc{}) [[unlikely]]
-      return T{};
-    return result;
-    }
-  else if constexpr(std::floating_point<T>)
-    {
-    T result{};
-    auto const [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
-    if(ec != std::errc{}) [[unlikely]]
-      return T{};
-    return result;
-    }
-  else if constexpr(std::same_as<T, std::string>)
+  int rc{SQLITE_OK};
+  int bind_ix{};
+  std::size_t ix{};
+  glz::for_each_field(
+    record,
+    [&]<typename T>(T & value)
     {
-    return std::string(value);
+      if(rc == SQLITE_OK and glz::reflect<table_type>::keys[ix] != pk)
+        rc = bind(stmt, ++bind_ix, value);
+      ++ix;
     }
-  else
-    static_assert(false);
+  );
+  if(rc == SQLITE_OK)
+    rc = bind(stmt, ++bind_ix, pk_value);
+  if(rc != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
+  return step_done(h, stmt, query);
   }
 
+///\brief inserts or updates record by unique conflict_key with cached statement
+///\returns pk of inserted or updated row
 template<typename table_type>
-static int select_callback(
-  void * d,         /* Data provided in the 4th argument of sqlite3_exec() */
-  int argc,         /* The number of columns in row */
-  char ** argv,     /* An array of strings representing fields in the row */
-  char ** azcolname /* An array of strings representing column names */
-)
-  {
-  std::span<char *> fields{argv, size_t(argc)};
-  std::span<char *> columns{azcolname, size_t(argc)};
-  table_type record{};
-  uint32_t ix = 0;
+static auto upsert(
+  sqlite3_handle_t & h,
+  std::string_view const pk,
+  std::string_view name,
+  std::string_view conflict_key,
+  table_type const & record
+) -> expected_ec<uint64_t>
+  {
+  static std::string const query{upsert_sql<table_type>(pk, name, conflict_key)};
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+
+  int rc{SQLITE_OK};
+  int bind_ix{};
+  std::size_t ix{};
   glz::for_each_field(
     record,
-    [&ix, &fields, &columns]<typename T>(T & value)
+    [&]<typename T>(T & value)
     {
-      auto const key{glz::reflect<table_type>::keys[ix]};
-      assert(key == std::string_view{columns[ix]});
-      value = deserialize<T>(fields[ix]);
+      if(rc == SQLITE_OK and glz::reflect<table_type>::keys[ix] != pk)
+        rc = bind(stmt, ++bind_ix, value);
       ++ix;
     }
   );
-  auto data{static_cast<std::vector<table_type> *>(d)};
-  data->emplace_back(std::move(record));
-  return 0;
+  if(rc != SQLITE_OK or sqlite3_step(stmt) != SQLITE_ROW) [[unlikely]]
+    return report_error(h, query);
+  return static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
   }
 
+///\brief reads current row into reflected fields in column order of select_sql
 template<typename table_type>
-static auto select_from(sqlite3 * db, std::string_view name, std::string_view where_clause)
-  -> cxx23::expected<std::vector<table_type>, std::error_code>
+auto read_row(sqlite3_stmt * stmt, table_type & record) -> void
   {
-  std::string query{std::format("SELECT ")};
-  uint32_t ix{};
+  int ix{};
   glz::for_each_field(
-    table_type{},
-    [&query, &ix]<typename T>(T &)
+    record,
+    [stmt, &ix]<typename T>(T & value)
     {
-      auto const key{glz::reflect<table_type>::keys[ix]};
-      query.append(std::format("{},", key));
+      value = read_column<T>(stmt, ix);
       ++ix;
     }
   );
-  query.pop_back();  // drop ,
-  query.append(std::format(" FROM {} {}", name, where_clause));
-  std::vector<table_type> result;
+  }
 
-  char * err_msg = nullptr;
-  int const rc = sqlite3_exec(db, query.c_str(), &select_callback<table_type>, &result, &err_msg);
+///\brief runs cached query built with select_sql, args are bound to its ? parameters
+template<typename table_type, typename... args_t>
+static auto select_rows(sqlite3_handle_t & h, std::string_view query, args_t const &... args)
+  -> cxx23::expected<std::vector<table_type>, std::error_code>
+  {
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+  if(bind_all(stmt, args...) != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
 
-  if(rc != SQLITE_OK)
+  std::vector<table_type> result;
+  for(;;)
     {
-    spdlog::error("[sql] {} {}", query, err_msg);
-    sqlite3_free(err_msg);
-    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+    int const rc{sqlite3_step(stmt)};
+    if(rc == SQLITE_DONE)
+      break;
+    if(rc != SQLITE_ROW) [[unlikely]]
+      return report_error(h, query);
+
+    read_row(stmt, result.emplace_back());
     }
-  spdlog::debug("[sql] {}", query);
   return result;
   }
 
-template<typename value_type>
-static int select_single_callback(
-  void * d,     /* Data provided in the 4th argument of sqlite3_exec() */
-  int argc,     /* The number of columns in row */
-  char ** argv, /* An array of strings representing fields in the row */
-  char **       /* An array of strings representing column names */
-)
+///\brief runs cached query built with select_sql passing each row to sink without collecting result
+template<typename table_type, typename row_sink, typename... args_t>
+static auto for_each_row(sqlite3_handle_t & h, std::string_view query, row_sink && sink, args_t const &... args)
+  -> expected_ec<void>
   {
-  assert(argc == 1);
-  std::span<char *> fields{argv, size_t(argc)};
-  std::optional<value_type> & value{*static_cast<std::optional<value_type> *>(d)};
-  value = deserialize<value_type>(fields[0]);
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+  if(bind_all(stmt, args...) != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
 
-  return 0;
+  table_type record{};
+  for(;;)
+    {
+    int const rc{sqlite3_step(stmt)};
+    if(rc == SQLITE_DONE)
+      return {};
+    if(rc != SQLITE_ROW) [[unlikely]]
+      return report_error(h, query);
+    read_row(stmt, record);
+    if(auto res{sink(std::as_const(record))}; not res) [[unlikely]]
+      return res;
+    }
   }
 
-template<typename value_type>
-static auto select_signle_from(sqlite3 * db, std::string_view query)
+///\brief first column of first row, empty when query returns no rows
+template<typename value_type, typename... args_t>
+static auto select_single(sqlite3_handle_t & h, std::string_view query, args_t const &... args)
   -> cxx23::expected<std::optional<value_type>, std::error_code>
   {
-  std::optional<value_type> value{};
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+  if(bind_all(stmt, args...) != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
+
+  int const rc{sqlite3_step(stmt)};
+  if(rc == SQLITE_DONE)
+    return std::optional<value_type>{};
+  if(rc != SQLITE_ROW) [[unlikely]]
+    return report_error(h, query);
+  return std::optional<value_type>{read_column<value_type>(stmt, 0)};
+  }
+
+///\brief runs cached statement that does not return rows
+template<typename... args_t>
+static auto execute(sqlite3_handle_t & h, std::string_view query, args_t const &... args) -> expected_ec<void>
+  {
+  sqlite3_stmt * stmt{h.prepare(query)};
+  if(stmt == nullptr) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  statement_scope_t const scope{stmt};
+  if(bind_all(stmt, args...) != SQLITE_OK) [[unlikely]]
+    return report_error(h, query);
+  return step_done(h, stmt, query);
+  }
+
+static auto create_index(sqlite3 * db, sql_iface::index_def_t const & index) -> expected_ec<void>
+  {
+  std::string columns;
+  for(std::string_view column: index.columns)
+    if(not column.empty())
+      columns.append(std::format("{},", column));
+  columns.pop_back();  // drop ,
+  std::string const query{std::format(
+    "CREATE {}INDEX IF NOT EXISTS {} ON {} ({});", index.unique ? "UNIQUE "sv : ""sv, index.name, index.table, columns
+  )};
+
   char * err_msg = nullptr;
-  int const rc = sqlite3_exec(db, query.data(), &select_single_callback<value_type>, &value, &err_msg);
+  int const rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &err_msg);
 
   if(rc != SQLITE_OK)
     {
@@ -762,9 +978,18 @@ static auto select_signle_from(sqlite3 * db, std::string_view query)
     return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
     }
   spdlog::debug("[sql] {}", query);
-  return value;
+  return {};
+  }
+
+static auto create_indexes(sqlite3 * db) -> expected_ec<void>
+  {
+  for(sql_iface::index_def_t const & index: sql_iface::indexes)
+    if(auto res{create_index(db, index)}; not res) [[unlikely]]
+      return res;
+  return {};
   }
 
+///\brief one shot statements like schema changes, not cached
 static auto execute_query_no_result(sqlite3 * db, std::string_view query) -> expected_ec<void>
   {
   char * err_msg = nullptr;
@@ -779,31 +1004,112 @@ static auto execute_query_no_result(sqlite3 * db, std::string_view query) -> exp
   spdlog::debug("[sql] {}", query);
   return {};
   }
-  }  // namespace sqlite
 
-struct sqlite3_handle_t
+///\brief creates spatial index of system locations and fills it from already stored systems
+static auto create_location_index(sqlite3 * db) -> expected_ec<void>
   {
-  sqlite3 * db{};
+  if(auto res{execute_query_no_result(
+       db,
+       std::format(
+         "CREATE VIRTUAL TABLE IF NOT EXISTS {} USING rtree(id, min_x, max_x, min_y, max_y, min_z, max_z);",
+         sql_iface::tables::star_system_location
+       )
+     )};
+     not res) [[unlikely]]
+    return res;
+  return execute_query_no_result(
+    db,
+    std::format(
+      "INSERT OR REPLACE INTO {} SELECT system_address, loc_x, loc_x, loc_y, loc_y, loc_z, loc_z FROM {} "
+      "WHERE loc_x<>0 OR loc_y<>0 OR loc_z<>0;",
+      sql_iface::tables::star_system_location,
+      sql_iface::tables::star_system
+    )
+  );
+  }
 
-  sqlite3_handle_t() noexcept = default;
-  sqlite3_handle_t(sqlite3_handle_t &&) noexcept = delete;
-  auto operator=(sqlite3_handle_t &&) noexcept -> sqlite3_handle_t & = delete;
+///\brief recreates table with column types of current schema copying all rows with their primary keys
+///\details values are read with legacy encoding fallbacks of read_column and written with current encoding,
+/// indexes of table are dropped with old table and have to be created again
+template<typename table_type>
+static auto rebuild_table(sqlite3_handle_t & h, std::string_view const pk, std::string_view name) -> expected_ec<void>
+  {
+  std::string const old_name{std::format("{}_old", name)};
+  if(auto res{execute_query_no_result(h.db, std::format("ALTER TABLE {} RENAME TO {};", name, old_name))}; not res)
+    [[unlikely]]
+    return res;
+  if(auto res{create_table<table_type>(h.db, pk, name)}; not res) [[unlikely]]
+    return res;
 
-  void close()
+  if(auto res{for_each_row<table_type>(
+       h,
+       select_sql<table_type>(old_name, ""sv),
+       [&h, pk, name](table_type const & row) { return insert_into<table_type, true>(h, pk, name, row); }
+     )};
+     not res) [[unlikely]]
+    return res;
+
+  // cached statement of old table would keep it referenced
+  h.statements.clear();
+  return execute_query_no_result(h.db, std::format("DROP TABLE {};", old_name));
+  }
+  }  // namespace sqlite
+
+///\brief inserts signal, genus or atmosphere row of body, callers invalidate cached system owning the body
+template<typename value_type>
+static auto insert_body_child(
+  sqlite3_handle_t & h, std::string_view table, uint64_t ref_body_oid, value_type const & value
+) -> expected_ec<void>
+  {
+  return sqlite::insert_into(h, "oid"sv, table, sql_iface::to_db_fromat(ref_body_oid, value));
+  }
+
+auto system_cache_t::find(uint64_t system_address) -> star_system_t const *
+  {
+  auto it{index_.find(system_address)};
+  if(it == index_.end())
     {
-    if(db)
-      {
-      sqlite3_close(db);
-      db = nullptr;
-      }
+    ++misses_;
+    return nullptr;
     }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return &*it->second;
+  }
 
-  ~sqlite3_handle_t()
+auto system_cache_t::insert(star_system_t const & system) -> void
+  {
+  if(capacity_ == 0)
+    return;
+  if(auto it{index_.find(system.system_address)}; it != index_.end())
     {
-    if(db)
-      sqlite3_close(db);
+    *it->second = system;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
     }
-  };
+  if(entries_.size() == capacity_)
+    {
+    index_.erase(entries_.back().system_address);
+    entries_.pop_back();
+    }
+  entries_.push_front(system);
+  index_.emplace(system.system_address, entries_.begin());
+  }
+
+auto system_cache_t::erase(uint64_t system_address) noexcept -> void
+  {
+  if(auto it{index_.find(system_address)}; it != index_.end())
+    {
+    entries_.erase(it->second);
+    index_.erase(it);
+    }
+  }
+
+auto system_cache_t::clear() noexcept -> void
+  {
+  entries_.clear();
+  index_.clear();
+  }
 
 database_storage_t::database_storage_t(std::string_view db_path) :
     db_path_{db_path},
@@ -813,6 +1119,9 @@ database_storage_t::database_storage_t(std::string_view db_path) :
 
 database_storage_t::~database_storage_t() { close(); }
 
+///\brief log size at which commit checkpoints by itself, fallback for writers that never call checkpoint
+inline constexpr int wal_fallback_pages{10000};
+
 auto database_storage_t::open() -> expected_ec<void>
   {
   bool const needs_init = !std::filesystem::exists(db_path_);
@@ -822,12 +1131,237 @@ auto database_storage_t::open() -> expected_ec<void>
   if(rc != SQLITE_OK)
     return cxx23::unexpected(std::make_error_code(std::errc::io_error));
 
+  // in memory database has no write ahead log
+  if(db_path_ != ":memory:")
+    {
+    // readers run concurrently with writer, commits are synced only by checkpoints
+    if(auto res{sqlite::execute_query_no_result(db_->db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;"sv)};
+       not res) [[unlikely]]
+      return res;
+    // hook replaces automatic checkpoint after each commit, log is copied on commit only when it grows far beyond
+    // size at which writers calling checkpoint copy it
+    sqlite3_wal_hook(
+      db_->db,
+      [](void * storage, sqlite3 * db, char const * name, int pages) -> int
+      {
+        uint32_t & wal_pages{static_cast<database_storage_t *>(storage)->wal_pages_};
+        wal_pages = static_cast<uint32_t>(pages);
+        int log_pages{};
+        int copied_pages{};
+        if(pages >= wal_fallback_pages
+           and sqlite3_wal_checkpoint_v2(db, name, SQLITE_CHECKPOINT_PASSIVE, &log_pages, &copied_pages) == SQLITE_OK)
+          wal_pages = static_cast<uint32_t>(std::max(0, log_pages - copied_pages));
+        return SQLITE_OK;
+      },
+      this
+    );
+    }
+
   if(needs_init)
     return create_database();
 
+  return migrate();
+  }
+
+auto database_storage_t::open_read_only() -> expected_ec<void>
+  {
+  if(sqlite3_open_v2(db_path_.c_str(), &db_->db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) [[unlikely]]
+    {
+    spdlog::error("[sql] can not open {} {}", db_path_, sqlite3_errmsg(db_->db));
+    db_->close();
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  system_cache_ = system_cache_t{0};
+
+  auto version_res{sqlite::select_single<uint32_t>(*db_, "PRAGMA user_version"sv)};
+  if(not version_res) [[unlikely]]
+    return cxx23::unexpected{version_res.error()};
+  if(version_res->value_or(0u) != sql_iface::schema_version) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::protocol_not_supported));
   return {};
   }
 
+auto database_storage_t::checkpoint(uint32_t min_pages) -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  if(transaction_depth_ != 0 or wal_pages_ == 0 or wal_pages_ < min_pages)
+    return {};
+
+  int log_pages{};
+  int copied_pages{};
+  if(int const rc{sqlite3_wal_checkpoint_v2(db_->db, nullptr, SQLITE_CHECKPOINT_PASSIVE, &log_pages, &copied_pages)};
+     rc != SQLITE_OK) [[unlikely]]
+    {
+    spdlog::error("[sql] checkpoint {}", sqlite3_errmsg(db_->db));
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  // frames still needed by readers are copied by next checkpoint
+  wal_pages_ = static_cast<uint32_t>(std::max(0, log_pages - copied_pages));
+  spdlog::debug("[sql] checkpoint copied {} of {} pages", copied_pages, log_pages);
+  return {};
+  }
+
+///\brief creates full text indexes of names and fills them from already stored records
+///\details rowid of index entry is oid of name_entry row with kind and id of named record, so storing record again
+/// replaces its entry, ids of different kinds share whole 64 bit range
+static auto create_name_index(sqlite3 * db) -> expected_ec<void>
+  {
+  if(auto res{sqlite::execute_query_no_result(
+       db,
+       std::format(
+         "CREATE TABLE IF NOT EXISTS {} (oid INTEGER PRIMARY KEY, kind INTEGER NOT NULL, id INTEGER NOT NULL, "
+         "UNIQUE(kind, id));"
+         "CREATE VIRTUAL TABLE IF NOT EXISTS {} USING fts5(name, context, kind UNINDEXED, ref UNINDEXED, "
+         "tokenize='unicode61 remove_diacritics 2', prefix='2 3');"
+         "CREATE VIRTUAL TABLE IF NOT EXISTS {} USING fts5(name, tokenize='trigram');",
+         sql_iface::tables::name_entry,
+         sql_iface::tables::name_search,
+         sql_iface::tables::name_trigram
+       )
+     )};
+     not res) [[unlikely]]
+    return res;
+  return sqlite::execute_query_no_result(
+    db,
+    std::format(
+      "INSERT OR IGNORE INTO {10} (kind, id) SELECT {2}, system_address FROM {1};"
+      "INSERT OR IGNORE INTO {10} (kind, id) SELECT {4}, oid FROM {3};"
+      "INSERT OR IGNORE INTO {10} (kind, id) SELECT {6}, oid FROM {5};"
+      "INSERT OR IGNORE INTO {10} (kind, id) SELECT {8}, mission_id FROM {7} "
+      "WHERE destination_system<>'' OR redirected_system<>'';"
+      "INSERT OR REPLACE INTO {0} (rowid, name, context, kind, ref) "
+      "SELECT e.oid, s.name, '', {2}, s.system_address FROM {1} s "
+      "JOIN {10} e ON e.kind={2} AND e.id=s.system_address;"
+      "INSERT OR REPLACE INTO {0} (rowid, name, context, kind, ref) "
+      "SELECT e.oid, b.name, COALESCE(s.name, ''), {4}, b.ref_system_address FROM {3} b "
+      "JOIN {10} e ON e.kind={4} AND e.id=b.oid "
+      "LEFT JOIN {1} s ON s.system_address=b.ref_system_address;"
+      "INSERT OR REPLACE INTO {0} (rowid, name, context, kind, ref) "
+      "SELECT e.oid, f.name, '', {6}, f.oid FROM {5} f JOIN {10} e ON e.kind={6} AND e.id=f.oid;"
+      "INSERT OR REPLACE INTO {0} (rowid, name, context, kind, ref) "
+      "SELECT e.oid, "
+      "CASE WHEN redirected_system<>'' THEN redirected_system ELSE destination_system END, "
+      "trim(CASE WHEN redirected_system<>'' THEN redirected_station || ' ' || redirected_settlement "
+      "ELSE destination_station || ' ' || destination_settlement END), {8}, mission_id FROM {7} "
+      "JOIN {10} e ON e.kind={8} AND e.id=mission_id "
+      "WHERE destination_system<>'' OR redirected_system<>'';"
+      "INSERT OR REPLACE INTO {9} (rowid, name) SELECT rowid, name FROM {0};",
+      sql_iface::tables::name_search,
+      sql_iface::tables::star_system,
+      std::to_underlying(name_kind_e::star_system),
+      sql_iface::tables::body,
+      std::to_underlying(name_kind_e::body),
+      sql_iface::tables::faction_info,
+      std::to_underlying(name_kind_e::faction),
+      sql_iface::tables::mission,
+      std::to_underlying(name_kind_e::mission_destination),
+      sql_iface::tables::name_trigram,
+      sql_iface::tables::name_entry
+    )
+  );
+  }
+
+auto database_storage_t::migrate() -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+
+  auto version_res{sqlite::select_single<uint32_t>(*db_, "PRAGMA user_version"sv)};
+  if(not version_res) [[unlikely]]
+    return cxx23::unexpected{version_res.error()};
+  uint32_t const version{version_res->value_or(0u)};
+  if(version >= sql_iface::schema_version)
+    return {};
+
+  spdlog::info("[sql] migrating database from version {} to {}", version, sql_iface::schema_version);
+  if(version < 1)
+    if(auto res{sqlite::create_table<journal_checkpoint_t>(
+         db_->db, "journal"sv, sql_iface::tables::journal_checkpoint
+       )};
+       not res) [[unlikely]]
+      return res;
+
+  if(version < 2)
+    {
+    // unique faction name index requires single record per faction, updates were applied to the oldest one
+    if(auto res{sqlite::execute_query_no_result(
+         db_->db,
+         std::format(
+           "DELETE FROM {0} WHERE oid NOT IN (SELECT MIN(oid) FROM {0} GROUP BY name);", sql_iface::tables::faction_info
+         )
+       )};
+       not res) [[unlikely]]
+      return res;
+    if(auto res{sqlite::create_indexes(db_->db)}; not res) [[unlikely]]
+      return res;
+    }
+
+  if(version < 3)
+    {
+    // TEXT affinity would convert integers back to text, so tables with such columns are rebuilt
+    auto const rebuild = [this]() -> expected_ec<void>
+    {
+      if(auto res{
+           sqlite::rebuild_table<sql_iface::planet_details_t>(*db_, "oid"sv, sql_iface::tables::planet_details)
+         };
+         not res) [[unlikely]]
+        return res;
+      if(auto res{sqlite::rebuild_table<sql_iface::atmosphere_element_t>(
+           *db_, "oid"sv, sql_iface::tables::atmosphere_element
+         )};
+         not res) [[unlikely]]
+        return res;
+      if(auto res{sqlite::rebuild_table<info::faction_info_t>(*db_, "oid"sv, sql_iface::tables::faction_info)};
+         not res) [[unlikely]]
+        return res;
+      if(auto res{sqlite::rebuild_table<info::mission_t>(*db_, "mission_id"sv, sql_iface::tables::mission)}; not res)
+        [[unlikely]]
+        return res;
+      if(auto res{
+           sqlite::rebuild_table<journal_checkpoint_t>(*db_, "journal"sv, sql_iface::tables::journal_checkpoint)
+         };
+         not res) [[unlikely]]
+        return res;
+      return sqlite::create_indexes(db_->db);
+    };
+    if(auto res{begin_transaction()}; not res) [[unlikely]]
+      return res;
+    if(auto res{rebuild()}; not res) [[unlikely]]
+      {
+      rollback_transaction();
+      return res;
+      }
+    if(auto res{commit_transaction()}; not res) [[unlikely]]
+      return res;
+    }
+
+  if(version < 4)
+    if(auto res{sqlite::create_location_index(db_->db)}; not res) [[unlikely]]
+      return res;
+
+  if(version == 5)
+    // entries of version 5 were keyed by id shifted left by kind which collided for ids above 2^62
+    if(auto res{sqlite::execute_query_no_result(
+         db_->db,
+         std::format(
+           "DROP TABLE IF EXISTS {};DROP TABLE IF EXISTS {};",
+           sql_iface::tables::name_search,
+           sql_iface::tables::name_trigram
+         )
+       )};
+       not res) [[unlikely]]
+      return res;
+
+  if(version < 6)
+    if(auto res{create_name_index(db_->db)}; not res) [[unlikely]]
+      return res;
+
+  return sqlite::execute_query_no_result(
+    db_->db, std::format("PRAGMA user_version={}", sql_iface::schema_version)
+  );
+  }
+
 auto database_storage_t::create_database() -> expected_ec<void>
   {
   if(not db_->db)
@@ -878,62 +1412,295 @@ auto database_storage_t::create_database() -> expected_ec<void>
   if(auto res{sqlite::create_table<info::mission_t>(db_->db, "mission_id"sv, sql_iface::tables::mission)}; not res)
     [[unlikely]]
     return res;
+
+  if(auto res{
+       sqlite::create_table<journal_checkpoint_t>(db_->db, "journal"sv, sql_iface::tables::journal_checkpoint)
+     };
+     not res) [[unlikely]]
+    return res;
+
+  if(auto res{sqlite::create_indexes(db_->db)}; not res) [[unlikely]]
+    return res;
+
+  if(auto res{sqlite::create_location_index(db_->db)}; not res) [[unlikely]]
+    return res;
+
+  if(auto res{create_name_index(db_->db)}; not res) [[unlikely]]
+    return res;
+
+  return sqlite::execute_query_no_result(
+    db_->db, std::format("PRAGMA user_version={}", sql_iface::schema_version)
+  );
+  }
+
+auto database_storage_t::begin_transaction() -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+
+  if(transaction_depth_ == 0)
+    if(auto res{sqlite::execute(*db_, "BEGIN IMMEDIATE"sv)}; not res) [[unlikely]]
+      return res;
+  ++transaction_depth_;
   return {};
   }
 
-auto database_storage_t::store(info::mission_t const & value) -> expected_ec<void>
+auto database_storage_t::commit_transaction() -> expected_ec<void>
+  {
+  if(transaction_depth_ == 0)
+    return {};
+  if(--transaction_depth_ != 0)
+    return {};
+  if(auto res{sqlite::execute(*db_, "COMMIT"sv)}; not res) [[unlikely]]
+    {
+    rollback_transaction();
+    return res;
+    }
+  return {};
+  }
+
+auto database_storage_t::rollback_transaction() -> void
+  {
+  transaction_depth_ = 0;
+  system_cache_.clear();
+  faction_cache_.clear();
+  if(sqlite3_get_autocommit(db_->db) == 0)
+    if(auto res{sqlite::execute(*db_, "ROLLBACK"sv)}; not res) [[unlikely]]
+      spdlog::error("[sql] rollback failed");
+  }
+
+auto database_storage_t::commit_pending() -> expected_ec<void>
+  {
+  if(transaction_depth_ != 1)
+    return {};
+  if(auto res{sqlite::execute(*db_, "COMMIT"sv)}; not res) [[unlikely]]
+    {
+    rollback_transaction();
+    return res;
+    }
+  if(auto res{sqlite::execute(*db_, "BEGIN IMMEDIATE"sv)}; not res) [[unlikely]]
+    {
+    transaction_depth_ = 0;
+    return res;
+    }
+  return {};
+  }
+
+transaction_scope_t::transaction_scope_t(database_storage_t & db) : db_{db}
+  {
+  if(auto res{db_.begin_transaction()}; res) [[likely]]
+    active_ = true;
+  else
+    spdlog::error("[sql] failed to begin transaction");
+  }
+
+transaction_scope_t::~transaction_scope_t()
+  {
+  if(not active_)
+    return;
+  if(std::uncaught_exceptions() > uncaught_exceptions_) [[unlikely]]
+    db_.rollback_transaction();
+  else if(auto res{db_.commit_transaction()}; not res) [[unlikely]]
+    spdlog::error("[sql] failed to commit transaction");
+  }
+
+auto database_storage_t::store(journal_checkpoint_t const & value) -> expected_ec<void>
   {
   if(not db_->db)
     return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
 
-  return sqlite::insert_into<info::mission_t, true>(db_->db, "mission_id"sv, sql_iface::tables::mission, value);
+  return sqlite::insert_into<journal_checkpoint_t, true, true>(
+    *db_, "journal"sv, sql_iface::tables::journal_checkpoint, value
+  );
   }
 
-auto database_storage_t::load_missions() -> expected_ec<std::vector<info::mission_t>>
+auto database_storage_t::load_checkpoint(std::string_view journal) -> expected_ec<std::optional<journal_checkpoint_t>>
+  {
+  static std::string const query{
+    sqlite::select_sql<journal_checkpoint_t>(sql_iface::tables::journal_checkpoint, " WHERE journal=?"sv)
+  };
+  auto res{sqlite::select_rows<journal_checkpoint_t>(*db_, query, journal)};
+  if(not res) [[unlikely]]
+    return cxx23::unexpected{res.error()};
+  if(res->empty())
+    return {};
+  return std::move(res->front());
+  }
+
+auto database_storage_t::load_last_checkpoint() -> expected_ec<std::optional<journal_checkpoint_t>>
+  {
+  // journal names contain creation time so lexical order is chronological
+  static std::string const query{
+    sqlite::select_sql<journal_checkpoint_t>(sql_iface::tables::journal_checkpoint, " ORDER BY journal DESC LIMIT 1"sv)
+  };
+  auto res{sqlite::select_rows<journal_checkpoint_t>(*db_, query)};
+  if(not res) [[unlikely]]
+    return cxx23::unexpected{res.error()};
+  if(res->empty())
+    return {};
+  return std::move(res->front());
+  }
+
+///\brief adds or replaces entry of record in both full text indexes, see create_name_index for rowid
+static auto index_name(
+  sqlite3_handle_t & h, name_kind_e kind, uint64_t id, uint64_t ref, std::string_view name, std::string_view context
+) -> expected_ec<void>
   {
-  return sqlite::select_from<info::mission_t>(
-    db_->db,
-    sql_iface::tables::mission,
+  static std::string const entry_query{std::format(
+    "INSERT INTO {} (kind, id) VALUES (?, ?) ON CONFLICT(kind, id) DO UPDATE SET id=excluded.id RETURNING oid",
+    sql_iface::tables::name_entry
+  )};
+  static std::string const search_query{std::format(
+    "INSERT OR REPLACE INTO {} (rowid, name, context, kind, ref) VALUES (?, ?, ?, ?, ?)", sql_iface::tables::name_search
+  )};
+  static std::string const trigram_query{
+    std::format("INSERT OR REPLACE INTO {} (rowid, name) VALUES (?, ?)", sql_iface::tables::name_trigram)
+  };
+  if(name.empty())
+    return {};
+  auto rowid{sqlite::select_single<uint64_t>(h, entry_query, kind, id)};
+  if(not rowid) [[unlikely]]
+    return cxx23::unexpected{rowid.error()};
+  if(not *rowid) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+  if(auto res{sqlite::execute(h, search_query, **rowid, name, context, kind, ref)}; not res) [[unlikely]]
+    return res;
+  return sqlite::execute(h, trigram_query, **rowid, name);
+  }
+
+///\brief removes index entries of earlier stored copies of body, body stored again gets new oid and its own entry
+static auto unindex_body_copies(
+  sqlite3_handle_t & h, uint64_t system_address, events::body_id_t body_id, uint64_t body_oid
+) -> expected_ec<void>
+  {
+  static std::string const copy_query{std::format(
+    "SELECT oid FROM {} WHERE ref_system_address=? AND body_id=? AND oid<>? LIMIT 1", sql_iface::tables::body
+  )};
+  static std::array const remove_queries{
+    std::format(
+      "DELETE FROM {} WHERE rowid IN (SELECT e.oid FROM {} e JOIN {} b ON e.id=b.oid "
+      "WHERE e.kind=? AND b.ref_system_address=? AND b.body_id=? AND b.oid<>?)",
+      sql_iface::tables::name_search,
+      sql_iface::tables::name_entry,
+      sql_iface::tables::body
+    ),
     std::format(
-      " WHERE (status='accepted' and expiry >'{:%Y-%m-%dT%H:%M:%SZ}') OR status='redirected'",
-      std::chrono::system_clock::now()
+      "DELETE FROM {} WHERE rowid IN (SELECT e.oid FROM {} e JOIN {} b ON e.id=b.oid "
+      "WHERE e.kind=? AND b.ref_system_address=? AND b.body_id=? AND b.oid<>?)",
+      sql_iface::tables::name_trigram,
+      sql_iface::tables::name_entry,
+      sql_iface::tables::body
+    ),
+    std::format(
+      "DELETE FROM {} WHERE kind=? AND id IN (SELECT oid FROM {} WHERE ref_system_address=? AND body_id=? AND oid<>?)",
+      sql_iface::tables::name_entry,
+      sql_iface::tables::body
     )
-    // where status='accepted' and expiry >'2026-01-07T10:43:00Z' or status='redirected'
+  };
+  // bodies are stored once in common case, single indexed lookup finds nothing to remove
+  auto copy{sqlite::select_single<uint64_t>(h, copy_query, system_address, body_id, body_oid)};
+  if(not copy) [[unlikely]]
+    return cxx23::unexpected{copy.error()};
+  if(not *copy)
+    return {};
+  for(std::string const & query: remove_queries)
+    if(auto res{sqlite::execute(h, query, name_kind_e::body, system_address, body_id, body_oid)}; not res) [[unlikely]]
+      return res;
+  return {};
+  }
+
+///\brief station and settlement of mission destination separated by space
+static auto destination_context(std::string_view station, std::string_view settlement) -> std::string
+  {
+  if(station.empty() or settlement.empty())
+    return std::string{station.empty() ? settlement : station};
+  return std::format("{} {}", station, settlement);
+  }
+
+auto database_storage_t::store(info::mission_t const & value) -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+
+  if(auto res{sqlite::insert_into<info::mission_t, true>(*db_, "mission_id"sv, sql_iface::tables::mission, value)};
+     not res) [[unlikely]]
+    return res;
+  return index_name(
+    *db_,
+    name_kind_e::mission_destination,
+    value.mission_id,
+    value.mission_id,
+    value.destination_system,
+    destination_context(value.destination_station, value.destination_settlement)
   );
   }
 
-auto database_storage_t::mission_exists(uint64_t mission_id) ->expected_ec<bool>
-{
-  if( auto res{sqlite::select_signle_from<uint32_t>(db_->db,
-    std::format("select count(*) from {} where mission_id={}",sql_iface::tables::mission,mission_id) )}; not res)
+auto database_storage_t::load_missions() -> expected_ec<std::vector<info::mission_t>>
+  {
+  // where status='accepted' and expiry >'2026-01-07T10:43:00Z' or status='redirected'
+  static std::string const query{sqlite::select_sql<info::mission_t>(
+    sql_iface::tables::mission, " WHERE (status=? and expiry >?) OR status=?"sv
+  )};
+  return sqlite::select_rows<info::mission_t>(
+    *db_,
+    query,
+    info::mission_status_e::accepted,
+    std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()),
+    info::mission_status_e::redirected
+  );
+  }
+
+auto database_storage_t::mission_exists(uint64_t mission_id) -> expected_ec<bool>
+  {
+  static std::string const query{
+    std::format("SELECT count(*) FROM {} WHERE mission_id=?", sql_iface::tables::mission)
+  };
+  if(auto res{sqlite::select_single<uint32_t>(*db_, query, mission_id)}; not res)
     return cxx23::unexpected{res.error()};
   else
-    return *res != 0;
-}
+    return res->value_or(0u) != 0;
+  }
+
 auto database_storage_t::change_mission_status(uint64_t mission_id, info::mission_status_e const status)
   -> expected_ec<void>
   {
-  std::string query{
-    std::format("UPDATE {} SET status='{}' WHERE mission_id={}", sql_iface::tables::mission, status, mission_id)
-  };
-  return sqlite::execute_query_no_result(db_->db, query);
+  static std::string const query{std::format("UPDATE {} SET status=? WHERE mission_id=?", sql_iface::tables::mission)};
+  return sqlite::execute(*db_, query, status, mission_id);
   }
 
 auto database_storage_t::redirect_mission(
   uint64_t mission_id, std::string_view system, std::string_view station, std::string_view settlement
 ) -> expected_ec<void>
   {
-  std::string query{std::format(
-    "UPDATE {} SET status='{}', redirected_system='{}', redirected_station='{}', redirected_settlement='{}' WHERE "
-    "mission_id={}",
-    sql_iface::tables::mission,
-    info::mission_status_e::redirected,
-    sqlite::escape_sql_quotes(system),
-    sqlite::escape_sql_quotes(station),
-    sqlite::escape_sql_quotes(settlement),
-    mission_id
+  static std::string const query{std::format(
+    "UPDATE {} SET status=?, redirected_system=?, redirected_station=?, redirected_settlement=? WHERE mission_id=?",
+    sql_iface::tables::mission
   )};
-  return sqlite::execute_query_no_result(db_->db, query);
+  if(auto res{
+       sqlite::execute(*db_, query, info::mission_status_e::redirected, system, station, settlement, mission_id)
+     };
+     not res) [[unlikely]]
+    return res;
+  return index_name(
+    *db_, name_kind_e::mission_destination, mission_id, mission_id, system, destination_context(station, settlement)
+  );
+  }
+
+///\brief keeps spatial index entry of system in sync with its stored location
+static auto index_system_location(
+  sqlite3_handle_t & h, uint64_t system_address, info::space_location_t const & loc
+) -> expected_ec<void>
+  {
+  static std::string const remove_query{
+    std::format("DELETE FROM {} WHERE id=?", sql_iface::tables::star_system_location)
+  };
+  static std::string const insert_query{
+    std::format("INSERT OR REPLACE INTO {} VALUES (?, ?, ?, ?, ?, ?, ?)", sql_iface::tables::star_system_location)
+  };
+  // systems without known location are stored at origin
+  if(loc == info::space_location_t{})
+    return sqlite::execute(h, remove_query, system_address);
+  return sqlite::execute(h, insert_query, system_address, loc[0], loc[0], loc[1], loc[1], loc[2], loc[2]);
   }
 
 auto database_storage_t::store(star_system_t const & system) -> expected_ec<void>
@@ -941,83 +1708,99 @@ auto database_storage_t::store(star_system_t const & system) -> expected_ec<void
   if(not db_->db)
     return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
 
-  if(auto res{sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::star_system, sql_iface::to_db_fromat(system))};
+  system_cache_.erase(system.system_address);
+  if(auto res{sqlite::insert_into(*db_, "oid"sv, sql_iface::tables::star_system, sql_iface::to_db_fromat(system))};
+     not res) [[unlikely]]
+    return res;
+  if(auto res{index_system_location(*db_, system.system_address, system.system_location)}; not res) [[unlikely]]
+    return res;
+  if(auto res{index_name(
+       *db_, name_kind_e::star_system, system.system_address, system.system_address, system.name, ""sv
+     )};
      not res) [[unlikely]]
     return res;
-  // auto const star_system_oid{sqlite3_last_insert_rowid(db_->db)};
   for(bary_centre_t const & bc: system.bary_centre)
     if(auto res{store(system.system_address, bc)}; not res) [[unlikely]]
       return res;
 
   for(body_t const & b: system.bodies)
-    if(auto res{store(system.system_address, b)}; not res) [[unlikely]]
+    if(auto res{store(system.system_address, system.name, b)}; not res) [[unlikely]]
       return cxx23::unexpected{res.error()};
   return {};
   }
 
 auto database_storage_t::store_fss_complete(uint64_t system_address) -> expected_ec<void>
   {
-  std::string query{
-    std::format("UPDATE {} SET fss_complete=1  WHERE system_address={}", sql_iface::tables::star_system, system_address)
+  static std::string const query{
+    std::format("UPDATE {} SET fss_complete=1 WHERE system_address=?", sql_iface::tables::star_system)
   };
-  return sqlite::execute_query_no_result(db_->db, query);
+  system_cache_.erase(system_address);
+  return sqlite::execute(*db_, query, system_address);
   }
 
 auto database_storage_t::store_system_location(uint64_t system_address, std::array<double, 3> const & loc)
   -> expected_ec<void>
   {
-  std::string query{std::format(
-    "UPDATE {} SET loc_x={}, loc_y={}, loc_z={} WHERE system_address={}",
-    sql_iface::tables::star_system,
-    loc[0],
-    loc[1],
-    loc[2],
-    system_address
-  )};
-  return sqlite::execute_query_no_result(db_->db, query);
+  static std::string const query{
+    std::format("UPDATE {} SET loc_x=?, loc_y=?, loc_z=? WHERE system_address=?", sql_iface::tables::star_system)
+  };
+  system_cache_.erase(system_address);
+  if(auto res{sqlite::execute(*db_, query, loc[0], loc[1], loc[2], system_address)}; not res) [[unlikely]]
+    return res;
+  return index_system_location(*db_, system_address, loc);
   }
 
 auto database_storage_t::store(uint64_t system_address, bary_centre_t const & bc) -> expected_ec<void>
   {
+  system_cache_.erase(system_address);
   return sqlite::insert_into(
-    db_->db, "oid"sv, sql_iface::tables::bary_centre, sql_iface::to_db_fromat(system_address, bc)
+    *db_, "oid"sv, sql_iface::tables::bary_centre, sql_iface::to_db_fromat(system_address, bc)
   );
   }
 
-auto database_storage_t::store(uint64_t system_address, body_t const & value) -> expected_ec<uint64_t>
+auto database_storage_t::store(uint64_t system_address, std::string_view system_name, body_t const & value)
+  -> expected_ec<uint64_t>
   {
+  system_cache_.erase(system_address);
   if(auto res{
-       sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::body, sql_iface::to_db_fromat(system_address, value))
+       sqlite::insert_into(*db_, "oid"sv, sql_iface::tables::body, sql_iface::to_db_fromat(system_address, value))
      };
      not res)
     return cxx23::unexpected{res.error()};
 
-  auto const body_oid{sqlite3_last_insert_rowid(db_->db)};
+  auto const body_oid{static_cast<uint64_t>(sqlite3_last_insert_rowid(db_->db))};
+  if(auto res{unindex_body_copies(*db_, system_address, value.body_id, body_oid)}; not res) [[unlikely]]
+    return cxx23::unexpected{res.error()};
+  // body names are searched together with name of their system
+  if(auto res{index_name(*db_, name_kind_e::body, body_oid, system_address, value.name, system_name)}; not res)
+    [[unlikely]]
+    return cxx23::unexpected{res.error()};
+
   if(value.body_type() == body_type_e::planet)
     {
     planet_details_t const & pd{std::get<planet_details_t>(value.details)};
     if(auto res{
-         sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::planet_details, sql_iface::to_db_fromat(body_oid, pd))
+         sqlite::insert_into(*db_, "oid"sv, sql_iface::tables::planet_details, sql_iface::to_db_fromat(body_oid, pd))
        };
        not res)
       return cxx23::unexpected{res.error()};
 
     for(events::signal_t const & sig: pd.signals_)
-      if(auto res{store(body_oid, sig)}; not res)
+      if(auto res{insert_body_child(*db_, sql_iface::tables::signal, body_oid, sig)}; not res)
         return cxx23::unexpected{res.error()};
 
     for(events::genus_t const & sig: pd.genuses_)
-      if(auto res{store(body_oid, sig)}; not res)
+      if(auto res{insert_body_child(*db_, sql_iface::tables::genus, body_oid, sig)}; not res)
         return cxx23::unexpected{res.error()};
 
     for(events::atmosphere_element_t const & el: pd.atmosphere_composition)
-      if(auto res{store(body_oid, el)}; not res)
+      if(auto res{insert_body_child(*db_, sql_iface::tables::atmosphere_element, body_oid, el)}; not res)
         return cxx23::unexpected{res.error()};
     }
   else
     {
     if(auto res{sqlite::insert_into(
-         db_->db,
+         *db_,
          "oid"sv,
          sql_iface::tables::star_details,
          sql_iface::to_db_fromat(body_oid, std::get<star_details_t>(value.details))
@@ -1031,57 +1814,54 @@ auto database_storage_t::store(uint64_t system_address, body_t const & value) ->
 
 auto database_storage_t::store_dss_complete(uint64_t system_address, events::body_id_t body_id) -> expected_ec<void>
   {
+  system_cache_.erase(system_address);
   auto oidres{oid_for_body(system_address, body_id)};
   if(not oidres)
     return cxx23::unexpected{oidres.error()};
   std::optional<uint64_t> boid_oid{*oidres};
-  std::string query{
-    std::format("UPDATE {} SET mapped=1  WHERE ref_body_oid={}", sql_iface::tables::planet_details, *boid_oid)
+  static std::string const query{
+    std::format("UPDATE {} SET mapped=1 WHERE ref_body_oid=?", sql_iface::tables::planet_details)
   };
-  return sqlite::execute_query_no_result(db_->db, query);
+  return sqlite::execute(*db_, query, boid_oid);
   }
 
 auto database_storage_t::store_ring_body_id(
   uint64_t system_address, events::body_id_t parent_body_id, std::string_view ring_name, events::body_id_t ring_body_id
 ) -> expected_ec<void>
   {
-  std::string query{
-    std::format(
-      "UPDATE {} SET body_id={}  WHERE ref_system_address={} AND parent_body_id={} AND name='{}'",
-      sql_iface::tables::ring,
-      ring_body_id,
-      system_address,
-      parent_body_id,
-      sqlite::escape_sql_quotes(ring_name)
-    )
-
-  };
-  spdlog::warn("{}", query);
-  return sqlite::execute_query_no_result(db_->db, query);
+  static std::string const query{std::format(
+    "UPDATE {} SET body_id=? WHERE ref_system_address=? AND parent_body_id=? AND name=?", sql_iface::tables::ring
+  )};
+  system_cache_.erase(system_address);
+  return sqlite::execute(*db_, query, ring_body_id, system_address, parent_body_id, ring_name);
   }
 
 auto database_storage_t::store(uint64_t ref_body_oid, events::signal_t const & value) -> expected_ec<void>
   {
-  return sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::signal, sql_iface::to_db_fromat(ref_body_oid, value));
+  // owning system is not known without query, overloads taking system_address drop only its entry
+  system_cache_.clear();
+  return insert_body_child(*db_, sql_iface::tables::signal, ref_body_oid, value);
   }
 
 auto database_storage_t::store(uint64_t ref_body_oid, events::genus_t const & value) -> expected_ec<void>
   {
-  return sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::genus, sql_iface::to_db_fromat(ref_body_oid, value));
+  system_cache_.clear();
+  return insert_body_child(*db_, sql_iface::tables::genus, ref_body_oid, value);
   }
 
 auto database_storage_t::store(uint64_t system_address, ring_t const & value) -> expected_ec<void>
   {
-  return sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::ring, sql_iface::to_db_fromat(system_address, value));
+  system_cache_.erase(system_address);
+  return sqlite::insert_into(*db_, "oid"sv, sql_iface::tables::ring, sql_iface::to_db_fromat(system_address, value));
   }
 
 auto database_storage_t::oid_for_body(uint64_t system_address, events::body_id_t body_id)
   -> expected_ec<std::optional<uint64_t>>
   {
-  std::string query{std::format(
-    "SELECT oid from {} WHERE ref_system_address={} AND body_id='{}'", sql_iface::tables::body, system_address, body_id
-  )};
-  return sqlite::select_signle_from<uint64_t>(db_->db, query);
+  static std::string const query{
+    std::format("SELECT oid FROM {} WHERE ref_system_address=? AND body_id=?", sql_iface::tables::body)
+  };
+  return sqlite::select_single<uint64_t>(*db_, query, system_address, body_id);
   }
 
 auto database_storage_t::store(
@@ -1092,8 +1872,9 @@ auto database_storage_t::store(
   if(not resoid)
     return cxx23::unexpected{resoid.error()};
   std::optional<uint64_t> boid_oid{*resoid};
+  system_cache_.erase(system_address);
   for(events::signal_t const & sig: signals)
-    if(auto res{store(*boid_oid, sig)}; not res)
+    if(auto res{insert_body_child(*db_, sql_iface::tables::signal, *boid_oid, sig)}; not res)
       return cxx23::unexpected{res.error()};
 
   return {};
@@ -1107,8 +1888,9 @@ auto database_storage_t::store(
   if(not resoid)
     return cxx23::unexpected{resoid.error()};
   std::optional<uint64_t> boid_oid{*resoid};
+  system_cache_.erase(system_address);
   for(events::genus_t const & gen: genuses)
-    if(auto res{store(*boid_oid, gen)}; not res)
+    if(auto res{insert_body_child(*db_, sql_iface::tables::genus, *boid_oid, gen)}; not res)
       return cxx23::unexpected{res.error()};
 
   return {};
@@ -1124,29 +1906,24 @@ auto database_storage_t::store(uint64_t system_address, std::span<ring_t const>
 
 auto database_storage_t::store(uint64_t ref_body_oid, events::atmosphere_element_t const & value) -> expected_ec<void>
   {
-  if(auto res{sqlite::insert_into(
-       db_->db, "oid"sv, sql_iface::tables::atmosphere_element, sql_iface::to_db_fromat(ref_body_oid, value)
-     )};
-     not res)
-    return cxx23::unexpected{res.error()};
-  return {};
+  system_cache_.clear();
+  return insert_body_child(*db_, sql_iface::tables::atmosphere_element, ref_body_oid, value);
   }
 
 [[nodiscard]]
 auto database_storage_t::faction_oid(std::string_view name) -> expected_ec<std::optional<uint64_t>>
   {
-  std::string query{
-    std::format("SELECT oid FROM {} WHERE name='{}'", sql_iface::tables::faction_info, sqlite::escape_sql_quotes(name))
-  };
-  return sqlite::select_signle_from<uint64_t>(db_->db, query);
+  static std::string const query{std::format("SELECT oid FROM {} WHERE name=?", sql_iface::tables::faction_info)};
+  return sqlite::select_single<uint64_t>(*db_, query, name);
   }
 
 [[nodiscard]]
 auto database_storage_t::load_faction(std::string_view name) -> expected_ec<std::optional<info::faction_info_t>>
   {
-  auto res{sqlite::select_from<info::faction_info_t>(
-    db_->db, sql_iface::tables::faction_info, std::format(" WHERE name='{}'", sqlite::escape_sql_quotes(name))
-  )};
+  static std::string const query{
+    sqlite::select_sql<info::faction_info_t>(sql_iface::tables::faction_info, " WHERE name=?"sv)
+  };
+  auto res{sqlite::select_rows<info::faction_info_t>(*db_, query, name)};
   if(not res) [[unlikely]]
     return cxx23::unexpected{res.error()};
   if(not res->empty())
@@ -1160,123 +1937,685 @@ auto database_storage_t::load_faction(std::string_view name) -> expected_ec<std:
 
 auto database_storage_t::update_faction_info(info::faction_info_t const & faction) -> expected_ec<void>
   {
+  faction_cache_.erase(faction.name);
   if(faction.oid != -1)
-    return sqlite::update_pk(db_->db, "oid"sv, sql_iface::tables::faction_info, faction, faction.oid);
-  else
-    return sqlite::insert_into(db_->db, "oid"sv, sql_iface::tables::faction_info, faction);
+    return sqlite::update_pk(*db_, "oid"sv, sql_iface::tables::faction_info, faction, faction.oid);
+  if(auto res{sqlite::insert_into(*db_, "oid"sv, sql_iface::tables::faction_info, faction)}; not res) [[unlikely]]
+    return res;
+  auto const oid{static_cast<uint64_t>(sqlite3_last_insert_rowid(db_->db))};
+  return index_name(*db_, name_kind_e::faction, oid, oid, faction.name, ""sv);
   }
 
-auto database_storage_t::load_system(uint64_t system_address)
+///\brief reads system with all bodies and rings from database
+static auto query_system(sqlite3_handle_t & h, uint64_t system_address)
   -> cxx23::expected<std::optional<star_system_t>, std::error_code>
   {
-  auto res{sqlite::select_from<sql_iface::star_system_t>(
-    db_->db, sql_iface::tables::star_system, std::format(" WHERE system_address='{}'", system_address)
-  )};
+  // fixed number of queries regardless of body count, child rows are grouped in memory by owner oid
+  static std::string const bodies_of_system{
+    std::format(" WHERE ref_body_oid IN (SELECT oid FROM {} WHERE ref_system_address=?)", sql_iface::tables::body)
+  };
+  static std::string const rings_of_system{
+    std::format(" WHERE ref_body_oid IN (SELECT oid FROM {} WHERE ref_system_address=?)", sql_iface::tables::ring)
+  };
+  static std::string const system_query{
+    sqlite::select_sql<sql_iface::star_system_t>(sql_iface::tables::star_system, " WHERE system_address=?"sv)
+  };
+  static std::string const body_query{
+    sqlite::select_sql<sql_iface::body_t>(sql_iface::tables::body, " WHERE ref_system_address=?"sv)
+  };
+  static std::string const planet_query{
+    sqlite::select_sql<sql_iface::planet_details_t>(sql_iface::tables::planet_details, bodies_of_system)
+  };
+  static std::string const star_query{
+    sqlite::select_sql<sql_iface::star_details_t>(sql_iface::tables::star_details, bodies_of_system)
+  };
+  static std::string const signal_query{
+    sqlite::select_sql<sql_iface::signal_t>(sql_iface::tables::signal, bodies_of_system)
+  };
+  static std::string const genus_query{
+    sqlite::select_sql<sql_iface::genus_t>(sql_iface::tables::genus, bodies_of_system)
+  };
+  static std::string const ring_query{
+    sqlite::select_sql<sql_iface::ring_t>(sql_iface::tables::ring, " WHERE ref_system_address=?"sv)
+  };
+  static std::string const ring_signal_query{
+    sqlite::select_sql<sql_iface::signal_t>(sql_iface::tables::signal, rings_of_system)
+  };
+
+  auto res{sqlite::select_rows<sql_iface::star_system_t>(h, system_query, system_address)};
   if(not res) [[unlikely]]
     return cxx23::unexpected{res.error()};
+  if(res->empty())
+    return {};
 
-  if(not res->empty())
+  assert(res->size() == 1);
+  star_system_t system{to_native_fromat(std::move((*res)[0]))};
+
+  // body oid -> index in system.bodies
+  std::unordered_map<uint64_t, std::size_t> body_index;
     {
-    assert(res->size() == 1);
-    star_system_t system{to_native_fromat(std::move((*res)[0]))};
+    auto bodies{sqlite::select_rows<sql_iface::body_t>(h, body_query, system_address)};
+    if(not bodies) [[unlikely]]
+      return cxx23::unexpected{bodies.error()};
+    system.bodies.reserve(bodies->size());
+    body_index.reserve(bodies->size());
+    for(sql_iface::body_t & body: *bodies)
+      {
+      body_index.emplace(body.oid, system.bodies.size());
+      system.bodies.emplace_back(sql_iface::to_native_fromat(std::move(body)));
+      }
+    }
+  auto const body_for = [&](uint64_t oid) -> body_t *
+  {
+    auto it{body_index.find(oid)};
+    return it != body_index.end() ? &system.bodies[it->second] : nullptr;
+  };
+  auto const planet_for = [&](uint64_t oid) -> planet_details_t *
+  {
+    body_t * body{body_for(oid)};
+    return body != nullptr ? std::get_if<planet_details_t>(&body->details) : nullptr;
+  };
 
+    {
+    auto planets{sqlite::select_rows<sql_iface::planet_details_t>(h, planet_query, system_address)};
+    if(not planets) [[unlikely]]
+      return cxx23::unexpected{planets.error()};
+    for(sql_iface::planet_details_t const & details: *planets)
+      if(body_t * body{body_for(details.ref_body_oid)}; body != nullptr)
+        body->details = sql_iface::to_native_fromat(details);
+    }
+    {
+    auto stars{sqlite::select_rows<sql_iface::star_details_t>(h, star_query, system_address)};
+    if(not stars) [[unlikely]]
+      return cxx23::unexpected{stars.error()};
+    for(sql_iface::star_details_t const & details: *stars)
+      if(body_t * body{body_for(details.ref_body_oid)}; body != nullptr)
+        body->details = sql_iface::to_native_fromat(details);
+    }
+    {
+    auto signals{sqlite::select_rows<sql_iface::signal_t>(h, signal_query, system_address)};
+    if(not signals) [[unlikely]]
+      return cxx23::unexpected{signals.error()};
+    for(sql_iface::signal_t const & sig: *signals)
+      if(planet_details_t * details{planet_for(sig.ref_body_oid)}; details != nullptr)
+        details->signals_.emplace_back(sql_iface::to_native_fromat(sig));
+    }
+    {
+    auto genuses{sqlite::select_rows<sql_iface::genus_t>(h, genus_query, system_address)};
+    if(not genuses) [[unlikely]]
+      return cxx23::unexpected{genuses.error()};
+    for(sql_iface::genus_t const & genus: *genuses)
+      if(planet_details_t * details{planet_for(genus.ref_body_oid)}; details != nullptr)
+        details->genuses_.emplace_back(sql_iface::to_native_fromat(genus));
+    }
+
+  // rings
+    {
+    auto rings{sqlite::select_rows<sql_iface::ring_t>(h, ring_query, system_address)};
+    if(not rings) [[unlikely]]
+      return cxx23::unexpected{rings.error()};
+    std::unordered_map<uint64_t, std::size_t> ring_index;
+    ring_index.reserve(rings->size());
+    system.rings.reserve(rings->size());
+    for(sql_iface::ring_t & db_ring: *rings)
       {
-      auto res2{sqlite::select_from<sql_iface::body_t>(
-        db_->db, sql_iface::tables::body, std::format(" WHERE ref_system_address='{}'", system_address)
-      )};
-      if(not res2) [[unlikely]]
-        return cxx23::unexpected{res.error()};
+      ring_index.emplace(db_ring.oid, system.rings.size());
+      system.rings.emplace_back(sql_iface::to_native_fromat(std::move(db_ring)));
+      }
 
-      std::vector<sql_iface::body_t> bodies{std::move(*res2)};
-      for(sql_iface::body_t & body: bodies)
-        {
-        system.bodies.emplace_back(sql_iface::to_native_fromat(std::move(body)));
-        body_t & out_body{system.bodies.back()};
-
-        if(body_type_e(body.details_type) == body_type_e::planet)
-          {
-          auto res3{sqlite::select_from<sql_iface::planet_details_t>(
-            db_->db, sql_iface::tables::planet_details, std::format(" WHERE ref_body_oid='{}'", body.oid)
-          )};
-          if(not res3) [[unlikely]]
-            return cxx23::unexpected{res.error()};
-          assert(res3->size() == 1);
-          out_body.details = sql_iface::to_native_fromat((*res3)[0]);
-          planet_details_t & details{std::get<planet_details_t>(out_body.details)};
-
-            {
-            auto res4{sqlite::select_from<sql_iface::signal_t>(
-              db_->db, sql_iface::tables::signal, std::format(" WHERE ref_body_oid='{}'", body.oid)
-            )};
-            if(not res4) [[unlikely]]
-              return cxx23::unexpected{res.error()};
-            if(not res4->empty())
-              std::ranges::transform(
-                *res4,
-                std::back_inserter(details.signals_),
-                [](sql_iface::signal_t & sig) -> events::signal_t
-                { return sql_iface::to_native_fromat(std::move(sig)); }
-              );
-            }
-            {
-            auto res4{sqlite::select_from<sql_iface::genus_t>(
-              db_->db, sql_iface::tables::genus, std::format(" WHERE ref_body_oid='{}'", body.oid)
-            )};
-            if(not res4) [[unlikely]]
-              return cxx23::unexpected{res.error()};
-            if(not res4->empty())
-              std::ranges::transform(
-                *res4,
-                std::back_inserter(details.genuses_),
-                [](sql_iface::genus_t & sig) -> events::genus_t { return sql_iface::to_native_fromat(std::move(sig)); }
-              );
-            }
-          }
-        else
-          {
-          auto res3{sqlite::select_from<sql_iface::star_details_t>(
-            db_->db, sql_iface::tables::star_details, std::format(" WHERE ref_body_oid='{}'", body.oid)
-          )};
-          if(not res3) [[unlikely]]
-            return cxx23::unexpected{res.error()};
-          assert(res3->size() == 1);
-          out_body.details = sql_iface::to_native_fromat((*res3)[0]);
-          }
-        }
+    auto signals{sqlite::select_rows<sql_iface::signal_t>(h, ring_signal_query, system_address)};
+    if(not signals) [[unlikely]]
+      return cxx23::unexpected{signals.error()};
+    for(sql_iface::signal_t const & sig: *signals)
+      if(auto it{ring_index.find(sig.ref_body_oid)}; it != ring_index.end())
+        system.rings[it->second].signals_.emplace_back(sql_iface::to_native_fromat(sig));
+    }
+  return system;
+  }
+
+auto database_storage_t::sync_factions(std::span<info::faction_info_t> factions) -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+
+  // transaction is started only when some faction changed
+  std::optional<transaction_scope_t> transaction;
+  for(info::faction_info_t & faction: factions)
+    {
+    if(auto it{faction_cache_.find(faction.name)}; it != faction_cache_.end() and it->second == faction)
+      {
+      faction.oid = it->second.oid;
+      continue;
       }
-      // rings
+    if(not transaction)
+      transaction.emplace(*this);
+    auto res{sqlite::upsert(*db_, "oid"sv, sql_iface::tables::faction_info, "name"sv, faction)};
+    if(not res) [[unlikely]]
       {
-      auto res4{sqlite::select_from<sql_iface::ring_t>(
-        db_->db, sql_iface::tables::ring, std::format(" WHERE ref_system_address='{}'", system_address)
-      )};
-      if(not res4) [[unlikely]]
-        return cxx23::unexpected{res.error()};
-      if(not res4->empty())
+      // scope would commit partial batch, rollback drops cached factions written by it too
+      rollback_transaction();
+      return cxx23::unexpected{res.error()};
+      }
+    faction.oid = static_cast<int64_t>(*res);
+    // names of factions do not change, only newly seen ones are indexed
+    if(faction_cache_.find(faction.name) == faction_cache_.end())
+      if(auto idxres{index_name(*db_, name_kind_e::faction, *res, *res, faction.name, ""sv)}; not idxres) [[unlikely]]
         {
-        for(sql_iface::ring_t & db_ring: *res4)
-          {
-          ring_t & ring{system.rings.emplace_back(sql_iface::to_native_fromat(std::move(db_ring)))};
-          auto res4{sqlite::select_from<sql_iface::signal_t>(
-            db_->db, sql_iface::tables::signal, std::format(" WHERE ref_body_oid='{}'", db_ring.oid)
-          )};
-          if(not res4) [[unlikely]]
-            return cxx23::unexpected{res.error()};
-          if(not res4->empty())
-            std::ranges::transform(
-              *res4,
-              std::back_inserter(ring.signals_),
-              [](sql_iface::signal_t & sig) -> events::signal_t { return sql_iface::to_native_fromat(std::move(sig)); }
-            );
-          }
+        rollback_transaction();
+        return idxres;
         }
+    faction_cache_.insert_or_assign(faction.name, faction);
+    }
+  return {};
+  }
+
+auto database_storage_t::load_system(uint64_t system_address)
+  -> cxx23::expected<std::optional<star_system_t>, std::error_code>
+  {
+  if(star_system_t const * cached{system_cache_.find(system_address)}; cached != nullptr)
+    return std::optional<star_system_t>{*cached};
+
+  auto res{query_system(*db_, system_address)};
+  if(res and res->has_value())
+    system_cache_.insert(**res);
+  return res;
+  }
+
+auto database_storage_t::query_plan(std::string_view query) -> expected_ec<std::vector<std::string>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+
+  std::string const explain{std::format("EXPLAIN QUERY PLAN {}", query)};
+  sqlite3_stmt * stmt{};
+  if(sqlite3_prepare_v2(db_->db, explain.c_str(), static_cast<int>(explain.size()), &stmt, nullptr) != SQLITE_OK)
+    [[unlikely]]
+    {
+    spdlog::error("[sql] {} {}", explain, sqlite3_errmsg(db_->db));
+    sqlite3_finalize(stmt);
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+  sqlite3_handle_t::statement_ptr const statement{stmt};
+  std::vector<std::string> result;
+  // columns: id, parent, notused, detail
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+    result.emplace_back(sqlite::column_text(stmt, 3));
+  return result;
+  }
+
+namespace sql_iface
+  {
+///\brief storage row read by row_cursor_t and its conversion to yielded row
+template<typename row_type>
+struct cursor_row_t;
+
+template<>
+struct cursor_row_t<::star_system_t>
+  {
+  using storage_type = sql_iface::star_system_t;
+
+  static auto convert(storage_type && row) -> ::star_system_t { return to_native_fromat(std::move(row)); }
+  };
+
+template<>
+struct cursor_row_t<system_body_t>
+  {
+  using storage_type = sql_iface::body_t;
+
+  static auto convert(storage_type && row) -> system_body_t
+    {
+    uint8_t const details_type{row.details_type};
+    system_body_t result{.system_address = row.ref_system_address, .body = to_native_fromat(std::move(row))};
+    if(details_type == std::to_underlying(body_type_e::planet))
+      result.body.details.emplace<::planet_details_t>();
+    return result;
+    }
+  };
+  }  // namespace sql_iface
+
+template<typename row_type>
+row_cursor_t<row_type>::~row_cursor_t()
+  {
+  sqlite3_finalize(stmt_);
+  }
+
+template<typename row_type>
+auto row_cursor_t<row_type>::next() -> expected_ec<std::optional<row_type>>
+  {
+  if(stmt_ == nullptr)
+    return std::optional<row_type>{};
+
+  int const rc{sqlite3_step(stmt_)};
+  if(rc == SQLITE_DONE)
+    {
+    // statement is released as soon as scan ends so it does not hold read lock until cursor is destroyed
+    sqlite3_finalize(std::exchange(stmt_, nullptr));
+    return std::optional<row_type>{};
+    }
+  if(rc != SQLITE_ROW) [[unlikely]]
+    {
+    spdlog::error("[sql] {} {}", sqlite3_sql(stmt_), sqlite3_errmsg(sqlite3_db_handle(stmt_)));
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+  using traits = sql_iface::cursor_row_t<row_type>;
+  typename traits::storage_type record{};
+  sqlite::read_row(stmt_, record);
+  return std::optional<row_type>{traits::convert(std::move(record))};
+  }
+
+template<typename row_type>
+auto row_cursor_t<row_type>::next_batch(std::vector<row_type> & batch, std::size_t max_rows)
+  -> expected_ec<std::size_t>
+  {
+  batch.clear();
+  while(batch.size() != max_rows)
+    {
+    auto res{next()};
+    if(not res) [[unlikely]]
+      return cxx23::unexpected{res.error()};
+    if(not res->has_value())
+      break;
+    batch.emplace_back(std::move(**res));
+    }
+  return batch.size();
+  }
+
+template struct row_cursor_t<star_system_t>;
+template struct row_cursor_t<system_body_t>;
+
+///\brief cursor over query built with select_sql, statement is not cached so scans may run concurrently
+template<typename row_type>
+static auto open_cursor(sqlite3_handle_t const & h, std::string_view query) -> expected_ec<row_cursor_t<row_type>>
+  {
+  if(not h.db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  sqlite3_stmt * stmt{};
+  if(sqlite3_prepare_v2(h.db, query.data(), static_cast<int>(query.size()), &stmt, nullptr) != SQLITE_OK)
+    [[unlikely]]
+    {
+    sqlite3_finalize(stmt);
+    return sqlite::report_error(h, query);
+    }
+  return row_cursor_t<row_type>{stmt};
+  }
+
+auto database_storage_t::scan_systems() -> expected_ec<row_cursor_t<star_system_t>>
+  {
+  static std::string const query{
+    sqlite::select_sql<sql_iface::star_system_t>(sql_iface::tables::star_system, " ORDER BY system_address"sv)
+  };
+  return open_cursor<star_system_t>(*db_, query);
+  }
+
+auto database_storage_t::scan_bodies() -> expected_ec<row_cursor_t<system_body_t>>
+  {
+  // order matches body_system_body_id index so no temporary b-tree is needed for sorting
+  static std::string const query{
+    sqlite::select_sql<sql_iface::body_t>(sql_iface::tables::body, " ORDER BY ref_system_address, body_id"sv)
+  };
+  return open_cursor<system_body_t>(*db_, query);
+  }
+
+///\brief systems with indexed location inside box, distance is measured from center
+static auto query_box(
+  sqlite3_handle_t & h,
+  info::space_location_t const & min_corner,
+  info::space_location_t const & max_corner,
+  info::space_location_t const & center
+) -> expected_ec<std::vector<nearby_system_t>>
+  {
+  // rtree selects candidates, rows are read by primary key
+  static std::string const query{sqlite::select_sql<sql_iface::star_system_t>(
+    sql_iface::tables::star_system,
+    std::format(
+      " WHERE system_address IN (SELECT id FROM {} WHERE max_x>=? AND min_x<=? AND max_y>=? AND min_y<=? AND "
+      "max_z>=? AND min_z<=?)",
+      sql_iface::tables::star_system_location
+    )
+  )};
+  std::vector<nearby_system_t> result;
+  auto res{sqlite::for_each_row<sql_iface::star_system_t>(
+    h,
+    query,
+    [&](sql_iface::star_system_t const & row) -> expected_ec<void>
+    {
+      info::space_location_t const location{row.loc_x, row.loc_y, row.loc_z};
+      result.emplace_back(nearby_system_t{
+        .system_address = row.system_address,
+        .name = row.name,
+        .location = location,
+        .distance = info::distance(center, location)
+      });
+      return {};
+    },
+    min_corner[0],
+    max_corner[0],
+    min_corner[1],
+    max_corner[1],
+    min_corner[2],
+    max_corner[2]
+  )};
+  if(not res) [[unlikely]]
+    return cxx23::unexpected{res.error()};
+  return result;
+  }
+
+///\brief drops systems of bounding box outside of sphere and orders remaining ones by distance
+static auto keep_within(std::vector<nearby_system_t> & systems, double radius) -> void
+  {
+  std::erase_if(systems, [radius](nearby_system_t const & system) { return system.distance > radius; });
+  std::ranges::sort(systems, std::ranges::less{}, &nearby_system_t::distance);
+  }
+
+auto database_storage_t::systems_within(info::space_location_t const & center, double radius)
+  -> expected_ec<std::vector<nearby_system_t>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  info::space_location_t const min_corner{center[0] - radius, center[1] - radius, center[2] - radius};
+  info::space_location_t const max_corner{center[0] + radius, center[1] + radius, center[2] + radius};
+  auto res{query_box(*db_, min_corner, max_corner, center)};
+  if(res)
+    keep_within(*res, radius);
+  return res;
+  }
+
+auto database_storage_t::systems_in_box(
+  info::space_location_t const & min_corner, info::space_location_t const & max_corner
+) -> expected_ec<std::vector<nearby_system_t>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  auto res{query_box(*db_, min_corner, max_corner, min_corner)};
+  if(res)
+    for(nearby_system_t & system: *res)
+      system.distance = 0.;
+  return res;
+  }
+
+auto database_storage_t::nearest_systems(info::space_location_t const & center, std::size_t count)
+  -> expected_ec<std::vector<nearby_system_t>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  // galaxy is about 100000 ly wide, bigger radius does not find more systems
+  constexpr double max_radius{131072.};
+  double radius{16.};
+  for(;;)
+    {
+    auto res{systems_within(center, radius)};
+    if(not res or res->size() >= count or radius >= max_radius)
+      {
+      if(res and res->size() > count)
+        res->resize(count);
+      return res;
+      }
+    radius *= 2.;
+    }
+  }
+
+///\brief copies all pages of main database of source into destination in single backup step
+static auto copy_database(sqlite3 * destination, sqlite3 * source) -> expected_ec<void>
+  {
+  sqlite3_backup * backup{sqlite3_backup_init(destination, "main", source, "main")};
+  if(backup == nullptr) [[unlikely]]
+    {
+    spdlog::error("[sql] backup init {}", sqlite3_errmsg(destination));
+    return cxx23::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+  int const rc{sqlite3_backup_step(backup, -1)};
+  sqlite3_backup_finish(backup);
+  if(rc != SQLITE_DONE) [[unlikely]]
+    {
+    spdlog::error("[sql] backup {}", sqlite3_errstr(rc));
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  return {};
+  }
+
+///\brief words of text split at the same characters as by unicode61 tokenizer, multibyte characters are kept
+static auto search_words(std::string_view text) -> std::vector<std::string_view>
+  {
+  auto const is_word_char = [](char c) noexcept
+  { return static_cast<unsigned char>(c) >= 0x80 or std::isalnum(static_cast<unsigned char>(c)) != 0; };
+  std::vector<std::string_view> words;
+  std::size_t begin{};
+  for(std::size_t ix{}; ix <= text.size(); ++ix)
+    if(ix == text.size() or not is_word_char(text[ix]))
+      {
+      if(ix != begin)
+        words.emplace_back(text.substr(begin, ix - begin));
+      begin = ix + 1;
       }
-    return system;
+  return words;
+  }
+
+///\brief fts5 string literal, double quotes are escaped by doubling
+static auto append_quoted(std::string & query, std::string_view text) -> void
+  {
+  query.push_back('"');
+  for(char c: text)
+    {
+    if(c == '"')
+      query.push_back('"');
+    query.push_back(c);
+    }
+  query.push_back('"');
+  }
+
+auto database_storage_t::search_names(std::string_view text, std::size_t limit)
+  -> expected_ec<std::vector<name_match_t>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  // name column weights 10 times more than context so system is ranked above its bodies
+  static std::string const query{std::format(
+    "SELECT kind, ref, name, context, bm25({0}, 10.0, 1.0) AS score FROM {0} WHERE {0} MATCH ? ORDER BY score LIMIT ?",
+    sql_iface::tables::name_search
+  )};
+  // every word has to match as prefix of some word of name or context
+  std::string match;
+  for(std::string_view word: search_words(text))
+    {
+    if(not match.empty())
+      match.push_back(' ');
+    append_quoted(match, word);
+    match.push_back('*');
+    }
+  if(match.empty())
+    return std::vector<name_match_t>{};
+  return sqlite::select_rows<name_match_t>(*db_, query, match, limit);
+  }
+
+auto database_storage_t::search_names_fuzzy(std::string_view text, std::size_t limit)
+  -> expected_ec<std::vector<name_match_t>>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  // trigram index selects and ranks candidates, details are read from name_search by the same rowid
+  static std::string const query{std::format(
+    "SELECT s.kind, s.ref, s.name, s.context, t.score FROM (SELECT rowid, bm25({1}) AS score FROM {1} WHERE {1} MATCH ? "
+    "ORDER BY score LIMIT ?) t JOIN {0} s ON s.rowid=t.rowid ORDER BY t.score",
+    sql_iface::tables::name_search,
+    sql_iface::tables::name_trigram
+  )};
+  // positions of utf-8 characters, trigrams are built of whole characters
+  std::vector<std::size_t> chars;
+  for(std::size_t ix{}; ix != text.size(); ++ix)
+    if((static_cast<unsigned char>(text[ix]) & 0xc0u) != 0x80u)
+      chars.push_back(ix);
+  if(chars.size() < 3)
+    return search_names(text, limit);
+  chars.push_back(text.size());
+
+  // any shared trigram selects name, names sharing more and rarer trigrams are ranked higher
+  std::string match;
+  for(std::size_t ix{}; ix + 3 < chars.size(); ++ix)
+    {
+    if(not match.empty())
+      match.append(" OR ");
+    append_quoted(match, text.substr(chars[ix], chars[ix + 3] - chars[ix]));
+    }
+  return sqlite::select_rows<name_match_t>(*db_, query, match, limit);
+  }
+
+///\brief checkpoints write ahead log of database about to be replaced and switches it to rollback journal
+///\details log left beside replaced file would be replayed into new one, fails when target is used by other
+/// connection as leaving write ahead log mode requires exclusive access
+static auto detach_wal(std::filesystem::path const & target) -> expected_ec<void>
+  {
+  std::filesystem::path wal{target};
+  wal += "-wal";
+  std::filesystem::path shm{target};
+  shm += "-shm";
+  std::error_code ec;
+  if(not std::filesystem::exists(target, ec))
+    {
+    // orphaned files of removed database
+    std::filesystem::remove(wal, ec);
+    std::filesystem::remove(shm, ec);
+    return {};
+    }
+  if(not std::filesystem::exists(wal, ec) and not std::filesystem::exists(shm, ec))
+    return {};
+
+  sqlite3 * db{};
+  if(sqlite3_open_v2(target.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) [[unlikely]]
+    {
+    spdlog::error("[sql] can not open {} {}", target.string(), sqlite3_errmsg(db));
+    sqlite3_close(db);
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  bool busy{true};
+  int rc{sqlite3_exec(
+    db,
+    "PRAGMA wal_checkpoint(TRUNCATE);",
+    [](void * busy_flag, int, char ** values, char **) -> int
+    {
+      *static_cast<bool *>(busy_flag) = values[0] == nullptr or values[0] != "0"sv;
+      return SQLITE_OK;
+    },
+    &busy,
+    nullptr
+  )};
+  if(rc == SQLITE_OK and not busy)
+    rc = sqlite3_exec(db, "PRAGMA journal_mode=DELETE;", nullptr, nullptr, nullptr);
+  sqlite3_close(db);
+  if(rc != SQLITE_OK or busy or std::filesystem::exists(wal, ec) or std::filesystem::exists(shm, ec)) [[unlikely]]
+    {
+    spdlog::error("[sql] {} is used by other connection", target.string());
+    return cxx23::unexpected(std::make_error_code(std::errc::device_or_resource_busy));
     }
   return {};
   }
 
+///\brief flushes directory entries so rename of file inside directory survives power loss
+static auto sync_directory(std::filesystem::path const & dir) -> expected_ec<void>
+  {
+  int const fd{::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+  if(fd < 0) [[unlikely]]
+    return cxx23::unexpected(std::error_code{errno, std::system_category()});
+  int const rc{::fsync(fd)};
+  int const error{errno};
+  ::close(fd);
+  if(rc != 0) [[unlikely]]
+    return cxx23::unexpected(std::error_code{error, std::system_category()});
+  return {};
+  }
+
+auto database_storage_t::save_as(std::string_view target_path) -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  if(transaction_depth_ != 0) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::device_or_resource_busy));
+
+  std::filesystem::path const target{target_path};
+  std::filesystem::path temporary{target};
+  temporary += ".tmp";
+  std::error_code ec;
+  // leftovers of interrupted save
+  std::filesystem::remove(temporary, ec);
+  std::filesystem::remove(std::filesystem::path{temporary} += "-journal", ec);
+
+  sqlite3 * destination{};
+  if(sqlite3_open_v2(temporary.c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK)
+    [[unlikely]]
+    {
+    spdlog::error("[sql] can not create {} {}", temporary.string(), sqlite3_errmsg(destination));
+    sqlite3_close(destination);
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  auto res{copy_database(destination, db_->db)};
+  // close syncs copy before it is renamed over target
+  if(sqlite3_close(destination) != SQLITE_OK and res) [[unlikely]]
+    res = cxx23::unexpected(std::make_error_code(std::errc::io_error));
+  if(not res) [[unlikely]]
+    {
+    std::filesystem::remove(temporary, ec);
+    return res;
+    }
+  if(auto detached{detach_wal(target)}; not detached) [[unlikely]]
+    {
+    std::filesystem::remove(temporary, ec);
+    return detached;
+    }
+
+  std::filesystem::rename(temporary, target, ec);
+  if(ec) [[unlikely]]
+    {
+    spdlog::error("[sql] can not replace {} {}", target.string(), ec.message());
+    return cxx23::unexpected(ec);
+    }
+  // rename is durable only once directory holding it is synced
+  if(auto res{sync_directory(target.has_parent_path() ? target.parent_path() : std::filesystem::path{"."})}; not res)
+    [[unlikely]]
+    {
+    spdlog::error("[sql] can not sync directory of {} {}", target.string(), res.error().message());
+    return res;
+    }
+  return {};
+  }
+
+auto database_storage_t::restore_from(std::string_view source_path) -> expected_ec<void>
+  {
+  if(not db_->db)
+    return cxx23::unexpected(std::make_error_code(std::errc::not_connected));
+  if(transaction_depth_ != 0) [[unlikely]]
+    return cxx23::unexpected(std::make_error_code(std::errc::device_or_resource_busy));
+
+  std::string const source_name{source_path};
+  sqlite3 * source{};
+  if(sqlite3_open_v2(source_name.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) [[unlikely]]
+    {
+    spdlog::error("[sql] can not open {} {}", source_name, sqlite3_errmsg(source));
+    sqlite3_close(source);
+    return cxx23::unexpected(std::make_error_code(std::errc::io_error));
+    }
+  // statements and cached rows refer to replaced content
+  db_->statements.clear();
+  system_cache_.clear();
+  faction_cache_.clear();
+  auto res{copy_database(db_->db, source)};
+  sqlite3_close(source);
+  if(not res) [[unlikely]]
+    return res;
+  return migrate();
+  }
+
 auto database_storage_t::close() -> void
   {
   if(db_->db)
+    {
+    // writes of transaction left open by coalescing are not lost
+    if(transaction_depth_ != 0)
+      {
+      transaction_depth_ = 1;
+      if(auto res{commit_transaction()}; not res) [[unlikely]]
+        spdlog::error("[sql] failed to commit pending writes on close");
+      }
+    if(auto res{checkpoint()}; not res) [[unlikely]]
+      spdlog::warn("[sql] failed to checkpoint on close");
     db_->close();
+    }
   }
@@ -544,6 +544,90 @@ static constexpr auto value_color(planet_value_e value)
 
 namespace
   {
+// journal lines are views into mapped file or tail buffer and are parsed in place, they are not null terminated
+inline constexpr glz::opts journal_read_opts{
+  []
+  {
+    glz::opts opts{};
+    opts.null_terminated = false;
+    opts.error_on_unknown_keys = false;
+    opts.error_on_missing_keys = false;
+    return opts;
+  }()
+};
+
+// lines are copied into null terminated buffer owned by parser_context_t
+inline constexpr glz::opts context_read_opts{
+  []
+  {
+    glz::opts opts{};
+    opts.error_on_unknown_keys = false;
+    opts.error_on_missing_keys = false;
+    return opts;
+  }()
+};
+
+inline constexpr std::size_t read_padding{64};
+
+template<typename T>
+inline constexpr bool is_std_optional_v = false;
+template<typename U>
+inline constexpr bool is_std_optional_v<std::optional<U>> = true;
+
+template<typename T>
+inline constexpr bool is_std_vector_v = false;
+template<typename U>
+inline constexpr bool is_std_vector_v<std::vector<U>> = true;
+
+template<typename T>
+inline constexpr bool is_std_array_v = false;
+template<typename U, std::size_t N>
+inline constexpr bool is_std_array_v<std::array<U, N>> = true;
+
+///\brief restores default values without releasing memory held by strings
+///\details vector elements are kept, glaze reads into existing elements and erases remaining ones
+template<typename T>
+auto reset_for_reuse(T & value) -> void
+  {
+  if constexpr(std::same_as<T, std::string>)
+    value.clear();
+  else if constexpr(is_std_optional_v<T>)
+    value.reset();
+  else if constexpr(is_std_vector_v<T> or is_std_array_v<T>)
+    for(auto & element: value)
+      reset_for_reuse(element);
+  else if constexpr(std::is_class_v<T> and std::is_aggregate_v<T>)
+    glz::for_each_field(value, []<typename field_t>(field_t & field) { reset_for_reuse(field); });
+  else
+    value = T{};
+  }
+
+template<typename T, typename... types>
+consteval auto variant_index_impl(std::variant<types...> const *) -> std::size_t
+  {
+  constexpr std::array matches{std::same_as<T, types>...};
+  return static_cast<std::size_t>(std::ranges::find(matches, true) - matches.begin());
+  }
+
+template<typename T>
+consteval auto variant_index() -> std::size_t
+  {
+  return variant_index_impl<T>(static_cast<events::event_holder_t const *>(nullptr));
+  }
+
+///\returns object of event_t cached in context reset to default values
+template<typename event_t>
+[[nodiscard]]
+auto cached_event(parser_context_t & context) -> events::event_holder_t &
+  {
+  std::optional<events::event_holder_t> & slot{context.cache[variant_index<event_t>()]};
+  if(not slot or not std::holds_alternative<event_t>(*slot))
+    slot.emplace(std::in_place_type<event_t>);
+  else
+    reset_for_reuse(std::get<event_t>(*slot));
+  return *slot;
+  }
+
 [[nodiscard]]
 auto load_nav_route(std::string journal_dir_path) -> cxx23::expected<events::nav_route_t, std::error_code>
   {
@@ -560,82 +644,152 @@ auto load_nav_route(std::string journal_dir_path) -> cxx23::expected<events::nav
   }
   }  // namespace
 
-auto generic_state_t::discovery(std::string_view input) -> void
+auto parse_journal_line(
+  parser_context_t & context,
+  std::string_view journal_dir_path,
+  std::string_view input,
+  events::event_filter_t const & filter,
+  events::event_filter_stats_t * stats
+) -> std::optional<parsed_event_ref_t>
   {
-  std::string buffer{input};
-  events::generic_event_t gevt;
-  auto parse_res{glz::read<glz::opts{.error_on_unknown_keys = false, .error_on_missing_keys = false}>(gevt, buffer)};
-  if(parse_res) [[unlikely]]
+  // typed struct is the only full parse of line, discriminator is found by prefix scan
+  std::string event_name_storage;
+  std::optional<journal_line_header_t> header{scan_journal_line_header(input)};
+  if(not header) [[unlikely]]
     {
-    warn("failed to parse {}", input);
-    return;
+    events::generic_event_t gevt;
+    if(auto parse_res{glz::read<journal_read_opts>(gevt, input)}; parse_res)
+      {
+      warn("failed to parse {}", input);
+      return std::nullopt;
+      }
+    event_name_storage = std::move(gevt.event);
+    header = journal_line_header_t{.timestamp = gevt.timestamp, .event = event_name_storage};
     }
+  parsed_event_ref_t result{.timestamp = header->timestamp, .event = nullptr};
   using enum events::event_e;
-  auto const parse_and_handle = [&]<typename event_t>() -> void
+  auto const parse = [&]<typename event_t>() -> std::optional<parsed_event_ref_t>
   {
-    event_t obj{};
-    auto const parse_res
-      = glz::read<glz::opts{.error_on_unknown_keys = false, .error_on_missing_keys = false}>(obj, buffer);
+    events::event_holder_t & holder{cached_event<event_t>(context)};
+    // glaze temporarily appends padding to non const std::string buffer, keep room for it so it does not reallocate
+    if(context.buffer.capacity() < input.size() + read_padding)
+      context.buffer.reserve(2u * input.size() + read_padding);
+    context.buffer.assign(input);
+    auto const parse_res{glz::read<context_read_opts>(std::get<event_t>(holder), context.buffer)};
 
     if(parse_res) [[unlikely]]
       {
-      // auto pre{stralgo::substr(input, parse_res.count - 40, 40)};
-      // auto post{stralgo::substr(input, parse_res.count, 40)};
-      warn("failed to parse {}", input);  // Assumes 'input' is available in scope
-      return;
+      warn("failed to parse {}", input);
+      return std::nullopt;
       }
-
-    handle(gevt.timestamp, std::move(obj));  // Assumes 'handle' is available in scope
+    result.event = &holder;
+    return result;
   };
-  auto castres{simple_enum::enum_cast<events::event_e>(gevt.event)};
+  auto castres{events::event_from_name(header->event)};
   if(not castres) [[unlikely]]
     {
-    warn("failed to cast event type {}", gevt.event);
-    return;
+    warn("failed to cast event type {}", header->event);
+    return std::nullopt;
     }
   events::event_e type{*castres};
+  if(not filter.accepts(type))
+    {
+    if(stats != nullptr)
+      {
+      stats->skipped_lines.fetch_add(1, std::memory_order_relaxed);
+      stats->skipped_bytes.fetch_add(input.size(), std::memory_order_relaxed);
+      }
+    return result;
+    }
   switch(type)
     {
-    case FSDJump:   parse_and_handle.template operator()<events::fsd_jump_t>(); break;
-    case FSDTarget: parse_and_handle.template operator()<events::fsd_target_t>(); break;
-    case StartJump: parse_and_handle.template operator()<events::start_jump_t>(); break;
-
-    case FSSDiscoveryScan:  parse_and_handle.template operator()<events::fss_discovery_scan_t>(); break;
-    case FSSBodySignals:    parse_and_handle.template operator()<events::fss_body_signals_t>(); break;
-    case FSSAllBodiesFound: parse_and_handle.template operator()<events::fss_all_bodies_found_t>(); break;
-    case ScanBaryCentre:    parse_and_handle.template operator()<events::scan_bary_centre_t>(); break;
-    case Scan:              parse_and_handle.template operator()<events::scan_detailed_scan_t>(); break;
-    case SAAScanComplete:   parse_and_handle.template operator()<events::saa_scan_complete_t>(); break;
-    case SAASignalsFound:   parse_and_handle.template operator()<events::dss_body_signals_t>(); break;
+    case FSDJump:   return parse.template operator()<events::fsd_jump_t>();
+    case FSDTarget: return parse.template operator()<events::fsd_target_t>();
+    case StartJump: return parse.template operator()<events::start_jump_t>();
+
+    case FSSDiscoveryScan:  return parse.template operator()<events::fss_discovery_scan_t>();
+    case FSSBodySignals:    return parse.template operator()<events::fss_body_signals_t>();
+    case FSSAllBodiesFound: return parse.template operator()<events::fss_all_bodies_found_t>();
+    case ScanBaryCentre:    return parse.template operator()<events::scan_bary_centre_t>();
+    case Scan:              return parse.template operator()<events::scan_detailed_scan_t>();
+    case SAAScanComplete:   return parse.template operator()<events::saa_scan_complete_t>();
+    case SAASignalsFound:   return parse.template operator()<events::dss_body_signals_t>();
     case Music:             break;
     case NavRoute:
         {
-        auto nr{load_nav_route(journal_dir_path_)};
+        auto nr{load_nav_route(std::string{journal_dir_path})};
         if(not nr) [[unlikely]]
           {
-          warn("failed to parse event type {}", gevt.event);
-          return;
+          warn("failed to parse event type {}", header->event);
+          return std::nullopt;
           }
-        handle(gevt.timestamp, std::move(*nr));
+        std::optional<events::event_holder_t> & slot{context.cache[variant_index<events::nav_route_t>()]};
+        slot.emplace(std::move(*nr));
+        result.event = &*slot;
         }
       break;
-    case NavRouteClear:     handle(gevt.timestamp, events::nav_route_clear_t{}); break;
-    case FuelScoop:         parse_and_handle.template operator()<events::fuel_scoop_t>(); break;
-    case Loadout:           parse_and_handle.template operator()<events::loadout_t>(); break;
-    case Location:          parse_and_handle.template operator()<events::location_t>(); break;
-    case MissionAbandoned:  parse_and_handle.template operator()<events::mission_abandoned_t>(); break;
-    case MissionAccepted:   parse_and_handle.template operator()<events::mission_accepted_t>(); break;
-    case MissionCompleted:  parse_and_handle.template operator()<events::mission_completed_t>(); break;
-    case MissionFailed:     parse_and_handle.template operator()<events::mission_failed_t>(); break;
-    case MissionRedirected: parse_and_handle.template operator()<events::mission_redirected_t>(); break;
-    case Missions:          parse_and_handle.template operator()<events::missions_t>(); break;
-    case Cargo:             parse_and_handle.template operator()<events::cargo_t>(); break;  //
+    case NavRouteClear:     result.event = &cached_event<events::nav_route_clear_t>(context); break;
+    case FuelScoop:         return parse.template operator()<events::fuel_scoop_t>();
+    case Loadout:           return parse.template operator()<events::loadout_t>();
+    case Location:          return parse.template operator()<events::location_t>();
+    case MissionAbandoned:  return parse.template operator()<events::mission_abandoned_t>();
+    case MissionAccepted:   return parse.template operator()<events::mission_accepted_t>();
+    case MissionCompleted:  return parse.template operator()<events::mission_completed_t>();
+    case MissionFailed:     return parse.template operator()<events::mission_failed_t>();
+    case MissionRedirected: return parse.template operator()<events::mission_redirected_t>();
+    case Missions:          return parse.template operator()<events::missions_t>();
+    case Cargo:             return parse.template operator()<events::cargo_t>();  //
     case Shutdown:          break;
     default:                break;
     }
+  return result;
+  }
+
+auto parse_journal_line(
+  std::string_view journal_dir_path,
+  std::string_view input,
+  events::event_filter_t const & filter,
+  events::event_filter_stats_t * stats
+) -> std::optional<parsed_line_t>
+  {
+  thread_local parser_context_t context;
+  std::optional<parsed_event_ref_t> const ref{parse_journal_line(context, journal_dir_path, input, filter, stats)};
+  if(not ref)
+    return std::nullopt;
+  parsed_line_t result{.timestamp = ref->timestamp, .event = {}};
+  if(ref->event != nullptr)
+    result.event.emplace(std::move(*ref->event));
+  return result;
+  }
+
+auto generic_state_t::discovery(std::string_view input) -> void
+  {
+  std::optional<parsed_event_ref_t> const line{
+    parse_journal_line(parser_, journal_dir_path_, input, event_filter_, &filter_stats_)
+  };
+  if(not line)
+    return;
+  last_event_timestamp_ = line->timestamp;
+  if(line->event != nullptr)
+    handle(line->timestamp, *line->event);
+  }
+
+auto generic_state_t::process_lines(std::span<std::string_view const> lines) -> void
+  {
+  begin_chunk();
+  for(std::string_view input: lines)
+    discovery(input);
+  end_chunk();
+  }
+
+auto generic_state_t::apply(parsed_line_t && line) -> void
+  {
+  last_event_timestamp_ = line.timestamp;
+  if(line.event)
+    handle(line.timestamp, *line.event);
   }
 
-auto to_body(events::scan_detailed_scan_t && event) -> body_t
+auto to_body(events::scan_detailed_scan_t const & event) -> body_t
   {
   body_t b{
     .value = {},
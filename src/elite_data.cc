@@ -27,10 +27,10 @@ auto faction_info_t::operator==(faction_info_t const & rh) const noexcept -> boo
          and influence == rh.influence and reputation == rh.reputation;
   }
 
-auto to_native(events::faction_info_t && faction) -> faction_info_t
+auto to_native(events::faction_info_t const & faction) -> faction_info_t
   {
   faction_info_t result{
-    .name = std::move(faction.Name), .oid = -1, .influence = faction.Influence, .reputation = faction.MyReputation
+    .name = faction.Name, .oid = -1, .influence = faction.Influence, .reputation = faction.MyReputation
   };
   if(auto castres{simple_enum::enum_cast<government_e>(to_lower(faction.Government))}; castres)
     result.government = *castres;
@@ -12,6 +12,7 @@
 #include <spdlog/spdlog.h>
 #include <elite_events.h>
 #include <database_import_state.h>
+#include <journal_import.h>
 
 namespace fs = std::filesystem;
 namespace po = boost::program_options;
@@ -29,7 +30,14 @@ auto main(int argc, char ** argv) -> int
   po::options_description desc("Opcje");
   desc.add_options()("help,h", "Wyświetl pomoc")(
     "dir,d", po::value<std::string>()->default_value("."), "journal folder"
-  );
+  )("rebuild", "usuń bazę danych i zaimportuj wszystkie dzienniki od nowa")(
+    "jobs,j", po::value<uint32_t>()->default_value(1u), "liczba wątków parsujących dzienniki, 0 - liczba rdzeni"
+  )(
+    "commit-every",
+    po::value<uint32_t>()->default_value(0u),
+    "liczba zdarzeń po której transakcja dziennika jest zatwierdzana razem z punktem kontrolnym, 0 - jedna transakcja na "
+    "dziennik"
+  )("fast", "importuj do bazy w pamięci i zapisz ją na dysk dopiero po udanym imporcie");
 
   po::variables_map vm;
   try
@@ -51,20 +59,154 @@ auto main(int argc, char ** argv) -> int
 
   auto const path = fs::path{vm["dir"].as<std::string>()};
 
-  if(fs::exists("ehtdb.sqlite"))
-    fs::remove("ehtdb.sqlite");
+  constexpr std::string_view db_path{"ehtdb.sqlite"};
+  // fast import builds database in memory and replaces file only when import succeeded
+  bool const fast{vm.count("fast") != 0};
+  bool const rebuild{vm.count("rebuild") != 0};
+  if(rebuild and not fast and fs::exists(db_path))
+    fs::remove(db_path);
   database_import_state_t dbimport{path.string()};
-  database_import_state_t::state_t state{"ehtdb.sqlite"};
+  database_import_state_t::state_t state{fast ? ":memory:" : db_path};
   if(not state.db_.open())
     return EXIT_FAILURE;
+  if(fast and not rebuild and fs::exists(db_path))
+    if(auto res{state.db_.restore_from(db_path)}; not res) [[unlikely]]
+      {
+      spdlog::error("failed to load {} into memory", db_path);
+      return EXIT_FAILURE;
+      }
   dbimport.state = &state;
-  std::vector<fs::path> journals{find_all_journals(path)};
+  dbimport.commit_every_ = vm["commit-every"].as<uint32_t>();
+  uint32_t jobs{vm["jobs"].as<uint32_t>()};
+  if(jobs == 0)
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  // journal state captured before import, stored as checkpoint after journal is applied
+  struct journal_info_t
+    {
+    uint64_t file_size;
+    int64_t mtime;
+    uint64_t resume_system_address;
+    };
+  std::vector<journal_import_task_t> tasks;
+  std::vector<journal_info_t> infos;
+  std::vector<fs::path> const journals{find_all_journals(path)};
   for(fs::path const & p: journals)
     {
-    std::println("Importing file: {}", p.string());
-    read_file(p, std::bind_front(&generic_state_t::discovery, &dbimport));
+    journal_info_t info{.file_size = fs::file_size(p), .mtime = file_mtime_seconds(p), .resume_system_address = 0};
+    uint64_t offset{};
+
+    auto checkpoint_res{state.db_.load_checkpoint(p.filename().string())};
+    if(not checkpoint_res) [[unlikely]]
+      return EXIT_FAILURE;
+    if(*checkpoint_res)
+      {
+      journal_checkpoint_t const & checkpoint{**checkpoint_res};
+      if(checkpoint.file_size == info.file_size and checkpoint.mtime == info.mtime)
+        continue;
+      // journal was appended since last import, truncated or replaced journals are imported again
+      if(checkpoint.offset <= info.file_size)
+        {
+        offset = checkpoint.offset;
+        info.resume_system_address = checkpoint.system_address;
+        }
+      }
+    // only newest journal may be still written by game
+    tasks.emplace_back(journal_import_task_t{.journal = p, .start_offset = offset, .complete = p != journals.back()});
+    infos.emplace_back(info);
     }
 
+  bool store_failed{};
+  auto const task_info = [&](journal_import_task_t const & task) -> journal_info_t const &
+  { return infos[static_cast<std::size_t>(&task - tasks.data())]; };
+
+  journal_import_callbacks_t const callbacks{
+    .on_journal_begin =
+      [&](journal_import_task_t const & task)
+    {
+      std::println("Importing file: {} from offset {}", task.journal.string(), task.start_offset);
+      // journal is committed together with its checkpoint, interrupted import resumes from previous one
+      if(auto res{state.db_.begin_transaction()}; not res) [[unlikely]]
+        {
+        spdlog::error("failed to begin transaction for {}", task.journal.string());
+        store_failed = true;
+        }
+      uint64_t const system_address{task_info(task).resume_system_address};
+      if(system_address != 0 and state.system.system_address != system_address)
+        if(auto sysres{state.db_.load_system(system_address)}; sysres and *sysres)
+          state.system = std::move(**sysres);
+    },
+    .on_chunk_end =
+      [&](journal_import_task_t const & task, uint64_t end_offset)
+    {
+      // size of checkpoint is position reached, so resume continues within journal unless it was read whole
+      journal_checkpoint_t const checkpoint{
+        .journal = task.journal.filename().string(),
+        .file_size = end_offset,
+        .mtime = task_info(task).mtime,
+        .offset = end_offset,
+        .last_event = dbimport.last_event_timestamp_,
+        .system_address = state.system.system_address
+      };
+      if(auto res{dbimport.commit_progress(checkpoint)}; not res) [[unlikely]]
+        {
+        spdlog::error("failed to commit {} at {}", checkpoint.journal, end_offset);
+        store_failed = true;
+        }
+    },
+    .on_journal_end =
+      [&](journal_import_task_t const & task, uint64_t end_offset)
+    {
+      journal_info_t const & info{task_info(task)};
+      journal_checkpoint_t const checkpoint{
+        .journal = task.journal.filename().string(),
+        .file_size = info.file_size,
+        .mtime = info.mtime,
+        .offset = end_offset,
+        .last_event = dbimport.last_event_timestamp_,
+        .system_address = state.system.system_address
+      };
+      if(auto res{state.db_.store(checkpoint)}; not res) [[unlikely]]
+        {
+        spdlog::error("failed to store checkpoint for {}", checkpoint.journal);
+        store_failed = true;
+        }
+      if(auto res{state.db_.commit_transaction()}; not res) [[unlikely]]
+        {
+        spdlog::error("failed to commit {}", checkpoint.journal);
+        store_failed = true;
+        }
+      dbimport.uncommitted_events_ = 0;
+      // log is not checkpointed on commit, importer copies it into database between journals
+      if(auto res{state.db_.checkpoint(1000)}; not res) [[unlikely]]
+        spdlog::warn("failed to checkpoint database after {}", checkpoint.journal);
+    }
+  };
+
+  auto const start{std::chrono::steady_clock::now()};
+  import_journals(tasks, dbimport, jobs, callbacks);
+  std::chrono::duration<double> const elapsed{std::chrono::steady_clock::now() - start};
+  std::println("Imported {} journals in {:.2f}s using {} jobs", tasks.size(), elapsed.count(), jobs);
+  std::println(
+    "Skipped {} lines ({} bytes) of events not stored in database",
+    dbimport.filter_stats_.skipped_lines.load(),
+    dbimport.filter_stats_.skipped_bytes.load()
+  );
+
+  if(store_failed)
+    return EXIT_FAILURE;
+
+  if(fast)
+    {
+    auto const save_start{std::chrono::steady_clock::now()};
+    if(auto res{state.db_.save_as(db_path)}; not res) [[unlikely]]
+      {
+      spdlog::error("failed to save {} {}", db_path, res.error().message());
+      return EXIT_FAILURE;
+      }
+    std::chrono::duration<double> const save_elapsed{std::chrono::steady_clock::now() - save_start};
+    std::println("Saved {} in {:.2f}s", db_path, save_elapsed.count());
+    }
   return 0;
   }
 
@@ -9,6 +9,18 @@
 #include <thread>
 #include <chrono>
 #include <print>
+#include <array>
+#include <span>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#endif
 
 
 auto find_all_journals(fs::path const & dir) -> std::vector<fs::path>
@@ -38,40 +50,476 @@ auto find_latest_journal(fs::path const & dir) -> std::optional<fs::path>
     return std::nullopt;
   return journals.back();
 }
-auto tail_file(fs::path const & path, process_callback const & cb, std::stop_token stoken) -> void
+
+auto file_mtime_seconds(fs::path const & path) -> int64_t
   {
-  // Tryb "współdzielony" w systemach POSIX to standardowy fstream.
-  // Na Windows można użyć specyficznych flag API, ale std::ifstream zazwyczaj wystarcza do odczytu logów.
-  std::ifstream file(path, std::ios::in);
-  if(!file.is_open())
+  struct stat st{};
+  if(::stat(path.c_str(), &st) != 0)
+    return 0;
+  return static_cast<int64_t>(st.st_mtime);
+  }
+
+namespace
+  {
+struct file_descriptor_t
+  {
+  int fd{-1};
+
+  file_descriptor_t() noexcept = default;
+
+  explicit file_descriptor_t(int value) noexcept : fd{value} {}
+
+  file_descriptor_t(file_descriptor_t const &) = delete;
+  auto operator=(file_descriptor_t const &) -> file_descriptor_t & = delete;
+
+  ~file_descriptor_t() { reset(); }
+
+  auto reset(int value = -1) noexcept -> void
     {
-    std::println(stderr, "Błąd: Nie można otworzyć pliku {}", path.string());
-    return;
+    if(fd >= 0)
+      ::close(fd);
+    fd = value;
     }
 
-  std::string line;
-  // Najpierw przeczytaj całą obecną zawartość
-  while(std::getline(file, line))
-    // std::println("{}", line);
-    cb(line);
-  file.clear();  // Czyścimy flagę EOF, aby móc czytać dalej
+  explicit operator bool() const noexcept { return fd >= 0; }
+  };
+
+///\brief splits appended bytes into lines, partially written line is kept until its end arrives
+///\details all complete lines read at once are delivered as one chunk of views into data
+struct line_splitter_t
+  {
+  static constexpr std::size_t read_size{64 * 1024};
+
+  /// unconsumed bytes, starts with incomplete line left from previous read
+  std::string data;
+  std::vector<std::string_view> lines;
+
+  auto deliver_complete(process_lines_callback const & cb, tail_stats_t * stats) -> void
+    {
+    lines.clear();
+    std::size_t const consumed{for_each_line(data, [this](std::string_view line) { lines.emplace_back(line); })};
+    if(not lines.empty())
+      {
+      if(stats != nullptr)
+        stats->lines += lines.size();
+      cb(lines);
+      }
+    data.erase(0, consumed);
+    }
+
+  ///\brief delivers unterminated last line of file that will not grow anymore
+  auto flush(process_lines_callback const & cb, tail_stats_t * stats) -> void
+    {
+    std::string_view line{data};
+    if(line.ends_with('\r'))
+      line.remove_suffix(1);
+    if(not line.empty())
+      {
+      if(stats != nullptr)
+        ++stats->lines;
+      cb(std::span{&line, 1});
+      }
+    data.clear();
+    }
+
+  ///\brief reads until end of file, offset is advanced by number of bytes read
+  auto read_available(int fd, process_lines_callback const & cb, tail_stats_t * stats, uint64_t & offset) -> void
+    {
+    for(;;)
+      {
+      std::size_t const old_size{data.size()};
+      ssize_t count{};
+      data.resize_and_overwrite(
+        old_size + read_size,
+        [fd, old_size, &count](char * buf, std::size_t) noexcept -> std::size_t
+        {
+          count = ::read(fd, buf + old_size, read_size);
+          return old_size + (count > 0 ? static_cast<std::size_t>(count) : 0u);
+        }
+      );
+      if(count > 0)
+        offset += static_cast<uint64_t>(count);
+      else if(count < 0 and errno == EINTR)
+        continue;
+      else
+        break;
+      }
+    deliver_complete(cb, stats);
+    }
+  };
+
+///\returns first journal in dir that sorts after current
+[[nodiscard]]
+auto next_journal(fs::path const & dir, fs::path const & current) -> std::optional<fs::path>
+  {
+  std::vector<fs::path> const journals{find_all_journals(dir)};
+  if(auto it{std::ranges::upper_bound(journals, current)}; it != journals.end())
+    return *it;
+  return std::nullopt;
+  }
+
+///\brief state of tailing single journal, optionally following newer journals created in the same directory
+struct tail_session_t
+  {
+  process_lines_callback const & cb;
+  tail_options_t const & options;
+  tail_stats_t * stats;
+  bool follow_dir;
+  fs::path dir;
+  fs::path path;
+  file_descriptor_t file;
+  line_splitter_t splitter;
+  uint64_t read_offset{};
+  std::chrono::steady_clock::time_point last_data;
+  bool idle_pending{};
+
+  tail_session_t(process_lines_callback const & callback, tail_options_t const & opts, bool follow) :
+      cb{callback},
+      options{opts},
+      stats{opts.stats},
+      follow_dir{follow}
+    {
+    }
 
+  [[nodiscard]]
+  auto open(fs::path const & p, uint64_t offset = 0) -> bool
+    {
+    file.reset(::open(p.c_str(), O_RDONLY | O_CLOEXEC));
+    if(not file)
+      {
+      std::println(stderr, "Błąd: Nie można otworzyć pliku {}", p.string());
+      return false;
+      }
+    path = p;
+    dir = p.has_parent_path() ? p.parent_path() : fs::path{"."};
+    splitter.data.clear();
+    read_offset = 0;
+    if(offset != 0)
+      {
+      if(::lseek(file.fd, static_cast<off_t>(offset), SEEK_SET) < 0)
+        {
+        std::println(stderr, "Błąd: Nie można przesunąć pliku {} do {}", p.string(), offset);
+        return false;
+        }
+      read_offset = offset;
+      }
+    return true;
+    }
+
+  auto report_progress() -> void
+    {
+    if(options.on_progress)
+      options.on_progress(journal_position_t{.journal = path, .offset = read_offset - splitter.data.size()});
+    }
+
+  auto read_available() -> bool
+    {
+    uint64_t const before{read_offset};
+    splitter.read_available(file.fd, cb, stats, read_offset);
+    if(read_offset == before)
+      return false;
+    report_progress();
+    last_data = std::chrono::steady_clock::now();
+    idle_pending = options.on_idle and options.idle_timeout.count() > 0;
+    return true;
+    }
+
+  ///\returns poll timeout in ms, -1 waits without limit when there is no idle notification pending
+  [[nodiscard]]
+  auto poll_timeout() const noexcept -> int
+    {
+    return idle_pending ? static_cast<int>(options.idle_timeout.count()) : -1;
+    }
+
+  ///\brief notifies once about idle period that followed delivered data
+  auto report_idle() -> void
+    {
+    if(not idle_pending or std::chrono::steady_clock::now() - last_data < options.idle_timeout)
+      return;
+    idle_pending = false;
+    options.on_idle();
+    }
+
+  ///\brief when newer journal exists finishes current one and continues with the next from offset 0
+  ///\returns true when journal was switched
+  [[nodiscard]]
+  auto switch_if_rotated() -> bool
+    {
+    if(not follow_dir)
+      return false;
+    std::optional<fs::path> const next{next_journal(dir, path)};
+    if(not next)
+      return false;
+    // game does not write to previous journal after creating new one, so consume its tail once
+    read_available();
+    if(not splitter.data.empty())
+      {
+      splitter.flush(cb, stats);
+      report_progress();
+      }
+    return open(*next);
+    }
+  };
+
+auto tail_polling(tail_session_t & session, std::stop_token const & stoken) -> void
+  {
+  constexpr uint32_t rotation_check_interval{20};  // ~1s
+  uint32_t idle_count{};
+  session.read_available();
   // Pętla monitorująca zmiany
   while(not stoken.stop_requested())
     {
-    if(std::getline(file, line))
+    if(session.read_available())
+      idle_count = 0;
+    else
       {
-      // std::println("{}", line);
-      cb(line);
+      if(++idle_count == rotation_check_interval)
+        {
+        idle_count = 0;
+        if(session.switch_if_rotated())
+          continue;
+        }
+      session.report_idle();
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
       }
-    else if(file.eof())
+    if(session.stats != nullptr)
+      ++session.stats->wakeups;
+    }
+  }
+
+#if defined(__linux__)
+///\returns true when any of queued events is creation of journal file
+[[nodiscard]]
+auto journal_created(std::span<char const> events) noexcept -> bool
+  {
+  std::size_t pos{};
+  bool created{};
+  while(pos + sizeof(inotify_event) <= events.size())
+    {
+    auto const * event{reinterpret_cast<inotify_event const *>(events.data() + pos)};
+    if(event->len != 0 and std::string_view{event->name}.contains("Journal"))
+      created = true;
+    pos += sizeof(inotify_event) + event->len;
+    }
+  return created;
+  }
+#endif
+
+///\returns false when inotify could not be set up or rotated journal could not be watched, session is continued
+/// by polling from position reached
+auto tail_inotify(tail_session_t & session, std::stop_token const & stoken) -> bool
+  {
+#if defined(__linux__)
+  file_descriptor_t const notify{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)};
+  file_descriptor_t const stop_event{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+  if(not notify or not stop_event)
+    return false;
+
+  int file_watch{::inotify_add_watch(notify.fd, session.path.c_str(), IN_MODIFY)};
+  if(file_watch < 0)
+    return false;
+  // directory watch wakes us when new journal is created or moved into place
+  if(::inotify_add_watch(notify.fd, session.dir.c_str(), IN_CREATE | IN_MOVED_TO) < 0)
+    return false;
+
+  std::stop_callback const wake_on_stop{
+    stoken,
+    [&stop_event]() noexcept
+    {
+      uint64_t const one{1};
+      [[maybe_unused]]
+      auto const res{::write(stop_event.fd, &one, sizeof(one))};
+    }
+  };
+
+  // watches are active so nothing appended from now on can be missed
+  session.read_available();
+  // journal could have been rotated before directory watch was set
+  bool check_rotation{true};
+
+  std::array<pollfd, 2> fds{
+    {{.fd = notify.fd, .events = POLLIN, .revents = 0}, {.fd = stop_event.fd, .events = POLLIN, .revents = 0}}
+  };
+  alignas(inotify_event) std::array<char, 4096> events;
+  while(not stoken.stop_requested())
+    {
+    while(check_rotation and session.switch_if_rotated())
       {
-      file.clear();
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      ::inotify_rm_watch(notify.fd, file_watch);
+      file_watch = ::inotify_add_watch(notify.fd, session.path.c_str(), IN_MODIFY);
+      // directory watch alone would not wake us for appends to new journal
+      if(file_watch < 0)
+        return false;
+      session.read_available();
       }
+    check_rotation = false;
+
+    int const ready{::poll(fds.data(), fds.size(), session.poll_timeout())};
+    if(ready < 0)
+      {
+      if(errno == EINTR)
+        continue;
+      std::println(stderr, "Błąd: poll dla pliku {} errno {}", session.path.string(), errno);
+      break;
+      }
+    if(ready == 0)
+      {
+      session.report_idle();
+      continue;
+      }
+    if(fds[1].revents != 0)
+      break;
+    if(session.stats != nullptr)
+      ++session.stats->wakeups;
+
+    for(;;)
+      {
+      ssize_t const count{::read(notify.fd, events.data(), events.size())};
+      if(count <= 0)
+        break;
+      if(journal_created(std::span{events.data(), static_cast<std::size_t>(count)}))
+        check_rotation = true;
+      }
+    session.read_available();
+    }
+  return true;
+#else
+  return false;
+#endif
+  }
+
+///\brief adapts per line callback to chunked delivery
+[[nodiscard]]
+auto each_line(process_callback const & cb) -> process_lines_callback
+  {
+  return [&cb](std::span<std::string_view const> lines)
+  {
+    for(std::string_view line: lines)
+      cb(line);
+  };
+  }
+
+auto run_session(tail_session_t & session, std::stop_token const & stoken) -> void
+  {
+  if(session.options.mode == tail_mode_e::inotify)
+    {
+    if(tail_inotify(session, stoken))
+      return;
+    std::println(stderr, "inotify niedostępne, przełączam na odpytywanie pliku {}", session.path.string());
     }
+  tail_polling(session, stoken);
+  }
+  }  // namespace
+
+auto tail_file(
+  fs::path const & path, process_lines_callback const & cb, std::stop_token stoken, tail_options_t const & options
+) -> void
+  {
+  tail_session_t session{cb, options, false};
+  if(not session.open(path))
+    return;
+  run_session(session, stoken);
   }
-auto read_file(fs::path const & path, process_callback const & cb) -> void
+
+auto tail_file(
+  fs::path const & path, process_callback const & cb, std::stop_token stoken, tail_options_t const & options
+) -> void
+  {
+  tail_file(path, each_line(cb), stoken, options);
+  }
+
+auto follow_journals(
+  fs::path const & dir, process_callback const & cb, std::stop_token stoken, tail_options_t const & options
+) -> void
+  {
+  follow_journals(dir, each_line(cb), stoken, options);
+  }
+
+auto follow_journals(
+  fs::path const & dir, process_lines_callback const & cb, std::stop_token stoken, tail_options_t const & options
+) -> void
+  {
+  tail_session_t session{cb, options, true};
+  // resume where previous run stopped, rotation check moves on to newer journals afterwards
+  if(options.start and fs::exists(options.start->journal))
+    {
+    uint64_t offset{options.start->offset};
+    if(offset > fs::file_size(options.start->journal))
+      offset = 0;
+    if(not session.open(options.start->journal, offset))
+      return;
+    run_session(session, stoken);
+    return;
+    }
+
+  std::optional<fs::path> latest{find_latest_journal(dir)};
+  // game was not started yet in fresh installation
+  while(not latest and not stoken.stop_requested())
+    {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    latest = find_latest_journal(dir);
+    }
+  if(not latest)
+    return;
+
+  if(not session.open(*latest))
+    return;
+  run_session(session, stoken);
+  }
+
+mapped_file_t::~mapped_file_t() { close(); }
+
+auto mapped_file_t::close() noexcept -> void
+  {
+  if(data_ != nullptr)
+    {
+    ::munmap(const_cast<char *>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    }
+  }
+
+auto mapped_file_t::open(fs::path const & path) -> bool
+  {
+  close();
+  file_descriptor_t const file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if(not file)
+    return false;
+
+  struct stat st{};
+  if(::fstat(file.fd, &st) != 0)
+    return false;
+  if(st.st_size == 0)
+    return true;
+
+  auto const size{static_cast<std::size_t>(st.st_size)};
+  void * addr{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0)};
+  if(addr == MAP_FAILED)
+    return false;
+  // journals are consumed once from begin to end, let kernel read ahead aggressively and drop pages behind
+  ::madvise(addr, size, MADV_SEQUENTIAL);
+  data_ = static_cast<char const *>(addr);
+  size_ = size;
+  return true;
+  }
+
+auto read_file(fs::path const & path, process_callback const & cb, uint64_t start_offset, bool deliver_partial_tail)
+  -> uint64_t
+  {
+  mapped_file_t mapped;
+  if(not mapped.open(path))
+    {
+    std::println(stderr, "Błąd: Nie można otworzyć pliku {}", path.string());
+    return start_offset;
+    }
+  std::string_view content{mapped.view()};
+  if(start_offset >= content.size())
+    return start_offset;
+  content.remove_prefix(start_offset);
+  return start_offset + for_each_line(content, cb, deliver_partial_tail);
+  }
+
+auto read_file_stream(fs::path const & path, process_callback const & cb) -> void
   {
   std::ifstream file(path, std::ios::in);
   if(!file.is_open())
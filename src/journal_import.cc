@@ -0,0 +1,152 @@
+#include <journal_import.h>
+#include <atomic>
+#include <future>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+///\brief lines of journal read together, applied by sequencer as one chunk
+struct parsed_chunk_t
+  {
+  std::size_t end_line;
+  uint64_t end_offset;
+  };
+
+///\brief journal parsed by worker, waiting for sequencer
+struct journal_batch_t
+  {
+  std::vector<parsed_line_t> lines;
+  std::vector<parsed_chunk_t> chunks;
+  uint64_t end_offset{};
+  };
+
+[[nodiscard]]
+///\details runs on worker threads, only members of state that are not modified during import are used
+auto parse_journal(generic_state_t & state, journal_import_task_t const & task) -> journal_batch_t
+  {
+  journal_batch_t batch;
+  batch.end_offset = read_file_chunks(
+    task.journal,
+    [&batch, &state](std::span<std::string_view const> lines, uint64_t end_offset)
+    {
+      for(std::string_view input: lines)
+        if(std::optional<parsed_line_t> line{
+             parse_journal_line(state.journal_dir_path_, input, state.event_filter_, &state.filter_stats_)
+           };
+           line)
+          batch.lines.emplace_back(std::move(*line));
+      batch.chunks.emplace_back(parsed_chunk_t{.end_line = batch.lines.size(), .end_offset = end_offset});
+    },
+    task.start_offset,
+    task.complete
+  );
+  return batch;
+  }
+
+auto import_sequential(
+  std::span<journal_import_task_t const> tasks, generic_state_t & state, journal_import_callbacks_t const & callbacks
+) -> void
+  {
+  for(journal_import_task_t const & task: tasks)
+    {
+    if(callbacks.on_journal_begin)
+      callbacks.on_journal_begin(task);
+    uint64_t const end_offset{read_file_chunks(
+      task.journal,
+      [&state, &task, &callbacks](std::span<std::string_view const> lines, uint64_t chunk_end)
+      {
+        state.process_lines(lines);
+        if(callbacks.on_chunk_end)
+          callbacks.on_chunk_end(task, chunk_end);
+      },
+      task.start_offset,
+      task.complete
+    )};
+    if(callbacks.on_journal_end)
+      callbacks.on_journal_end(task, end_offset);
+    }
+  }
+  }  // namespace
+
+auto import_journals(
+  std::span<journal_import_task_t const> tasks,
+  generic_state_t & state,
+  uint32_t jobs,
+  journal_import_callbacks_t const & callbacks
+) -> void
+  {
+  if(jobs <= 1 or tasks.size() <= 1)
+    {
+    import_sequential(tasks, state, callbacks);
+    return;
+    }
+
+  std::vector<std::promise<journal_batch_t>> parsed(tasks.size());
+  std::vector<std::future<journal_batch_t>> ready;
+  ready.reserve(tasks.size());
+  for(std::promise<journal_batch_t> & p: parsed)
+    ready.emplace_back(p.get_future());
+
+  // limits how far workers may run ahead of sequencer
+  std::counting_semaphore<> lookahead{static_cast<std::ptrdiff_t>(2u * jobs)};
+  std::atomic<std::size_t> next_task{};
+
+  std::vector<std::jthread> workers;
+  workers.reserve(jobs);
+  for(uint32_t i{}; i != jobs; ++i)
+    workers.emplace_back(
+      [&]
+      {
+        for(;;)
+          {
+          lookahead.acquire();
+          std::size_t const ix{next_task.fetch_add(1, std::memory_order_relaxed)};
+          if(ix >= tasks.size())
+            {
+            lookahead.release();
+            return;
+            }
+          try
+            {
+            parsed[ix].set_value(parse_journal(state, tasks[ix]));
+            }
+          catch(...)
+            {
+            parsed[ix].set_exception(std::current_exception());
+            }
+          }
+      }
+    );
+
+  try
+    {
+    for(std::size_t ix{}; ix != tasks.size(); ++ix)
+      {
+      journal_batch_t batch{ready[ix].get()};
+      lookahead.release();
+      if(callbacks.on_journal_begin)
+        callbacks.on_journal_begin(tasks[ix]);
+      std::size_t line_ix{};
+      for(parsed_chunk_t const & chunk: batch.chunks)
+        {
+        state.begin_chunk();
+        for(; line_ix != chunk.end_line; ++line_ix)
+          state.apply(std::move(batch.lines[line_ix]));
+        state.end_chunk();
+        if(callbacks.on_chunk_end)
+          callbacks.on_chunk_end(tasks[ix], chunk.end_offset);
+        }
+      if(callbacks.on_journal_end)
+        callbacks.on_journal_end(tasks[ix], batch.end_offset);
+      }
+    }
+  catch(...)
+    {
+    // let workers waiting for lookahead finish so they can be joined
+    next_task = tasks.size();
+    lookahead.release(static_cast<std::ptrdiff_t>(jobs));
+    throw;
+    }
+  }
@@ -0,0 +1,54 @@
+#include <read_pool.h>
+
+read_pool_t::~read_pool_t()
+  {
+  for(std::jthread & worker: workers_)
+    worker.request_stop();
+  workers_.clear();
+  }
+
+auto read_pool_t::open(std::string_view db_path, std::size_t connections) -> expected_ec<void>
+  {
+  connections_.reserve(connections);
+  for(std::size_t ix{}; ix != connections; ++ix)
+    {
+    auto db{std::make_unique<database_storage_t>(db_path)};
+    if(auto res{db->open_read_only()}; not res) [[unlikely]]
+      {
+      connections_.clear();
+      return res;
+      }
+    connections_.emplace_back(std::move(db));
+    }
+
+  workers_.reserve(connections);
+  for(std::unique_ptr<database_storage_t> & db: connections_)
+    workers_.emplace_back([this, &db = *db](std::stop_token stoken) { run(stoken, db); });
+  return {};
+  }
+
+auto read_pool_t::push(task_t task) -> void
+  {
+    {
+    std::lock_guard lock{mtx_};
+    tasks_.emplace_back(std::move(task));
+    }
+  not_empty_.notify_one();
+  }
+
+auto read_pool_t::run(std::stop_token stoken, database_storage_t & db) -> void
+  {
+  for(;;)
+    {
+    task_t task;
+      {
+      std::unique_lock lock{mtx_};
+      not_empty_.wait(lock, stoken, [this] { return not tasks_.empty(); });
+      if(stoken.stop_requested())
+        return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      }
+    task(db);
+    }
+  }
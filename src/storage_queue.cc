@@ -0,0 +1,80 @@
+#include <storage_queue.h>
+#include <spdlog/spdlog.h>
+
+storage_queue_t::storage_queue_t(database_storage_t & db, std::size_t capacity) :
+    db_{db},
+    capacity_{capacity},
+    worker_{[this](std::stop_token stoken) { run(stoken); }}
+  {
+  }
+
+storage_queue_t::~storage_queue_t()
+  {
+  // run() keeps applying tasks after stop request until queue is empty
+  worker_.request_stop();
+  worker_.join();
+  }
+
+auto storage_queue_t::push(task_t task) -> void
+  {
+    {
+    std::unique_lock lock{mtx_};
+    if(tasks_.size() >= capacity_)
+      {
+      stats_.stalls.fetch_add(1, std::memory_order_relaxed);
+      not_full_.wait(lock, [this] { return tasks_.size() < capacity_; });
+      }
+    tasks_.emplace_back(std::move(task));
+    }
+  not_empty_.notify_one();
+  }
+
+auto storage_queue_t::flush() -> void
+  {
+  std::unique_lock lock{mtx_};
+  drained_.wait(lock, [this] { return tasks_.empty() and not busy_; });
+  }
+
+auto storage_queue_t::after_commit(std::function<void()> fn) -> void
+  {
+  after_commit_.emplace_back(std::move(fn));
+  }
+
+auto storage_queue_t::run(std::stop_token stoken) -> void
+  {
+  std::deque<task_t> batch;
+  for(;;)
+    {
+      {
+      std::unique_lock lock{mtx_};
+      not_empty_.wait(lock, stoken, [this] { return not tasks_.empty(); });
+      if(tasks_.empty())
+        return;
+      batch.swap(tasks_);
+      busy_ = true;
+      }
+    not_full_.notify_all();
+
+      {
+      // joins coalescing transaction when one was started by task
+      transaction_scope_t const transaction{db_};
+      for(task_t & task: batch)
+        task(db_);
+      }
+    stats_.applied.fetch_add(batch.size(), std::memory_order_relaxed);
+    stats_.batches.fetch_add(1, std::memory_order_relaxed);
+    spdlog::debug("[storage] applied {} tasks", batch.size());
+    batch.clear();
+    for(std::function<void()> & fn: after_commit_)
+      fn();
+    after_commit_.clear();
+    if(auto res{db_.checkpoint(checkpoint_pages_)}; not res) [[unlikely]]
+      spdlog::warn("[storage] checkpoint failed {}", res.error().message());
+
+      {
+      std::lock_guard lock{mtx_};
+      busy_ = false;
+      }
+    drained_.notify_all();
+    }
+  }
@@ -3,6 +3,11 @@
 #include <elite_data.h>
 #include <simple_enum/simple_enum.hpp>
 #include <databse_storage.h>
+#include <storage_queue.h>
+#include <read_pool.h>
+#include <file_io.h>
+#include <mutex>
+#include <unordered_map>
 
 class main_window_t;
 
@@ -31,12 +36,56 @@ struct current_state_t : public generic_state_t
   
   std::vector<info::route_item_t> route_;
   uint64_t current_system_address_{};
+  ///\brief 0 commits each batch of storage thread, otherwise writes are coalesced and committed at most this often
+  std::chrono::milliseconds commit_window_{};
+  ///\brief coalescing transaction state, used only by storage thread
+  std::chrono::steady_clock::time_point transaction_start_;
+  bool coalescing_{};
+  ///\brief upcoming route systems and fsd target loaded before jump starts
+  std::unordered_map<uint64_t, star_system_t> prefetched_;
+  std::mutex prefetch_mtx_;
+  ///\brief changed when current system or route changes, systems loaded for older epoch are not kept
+  uint64_t prefetch_epoch_{};
+  ///\brief number of not visited route systems loaded ahead
+  std::size_t prefetch_depth_{3};
+  ///\brief read only connections loading prefetched systems off storage thread, storage thread is used when not open
+  ///\details declared after prefetch state used by its tasks and before storage_ which queues them
+  read_pool_t readers_;
+  ///\brief applies database writes on storage thread, all access to db_ after open goes through it
+  ///\details declared last so pending writes are applied before any other member is destroyed
+  storage_queue_t storage_;
 
-  current_state_t(main_window_t * p, std::string db_path, std::string journal_path) : generic_state_t{journal_path}, parent{p}, db_{db_path} {}
+  current_state_t(main_window_t * p, std::string db_path, std::string journal_path) : generic_state_t{journal_path}, parent{p}, db_{db_path}, storage_{db_} {}
 
-  void handle(std::chrono::sys_seconds timestamp, events::event_holder_t && event) override;
+  void handle(std::chrono::sys_seconds timestamp, events::event_holder_t const & event) override;
+  void begin_chunk() override;
+  void end_chunk() override;
+
+  ///\brief commits writes coalesced within commit_window_, called by tailing thread when journal is idle
+  void flush_pending();
   
   void route_system_visited(uint64_t system_address);
+
+  ///\brief restores system and missions from last journal checkpoint
+  ///\returns position to continue tailing from, nullopt when nothing was imported yet
+  auto resume() -> std::optional<journal_position_t>;
+
+  ///\brief records progress of tailing, called by follow_journals after delivered lines
+  void store_checkpoint(journal_position_t const & position);
 private:
+  ///\brief replaces active missions with accepted and redirected ones from database
   void load_missions();
+  [[nodiscard]]
+  auto load_system(uint64_t system_address) -> expected_ec<std::optional<star_system_t>>;
+  void store_system_location();
+  void store_factions(std::span<events::faction_info_t const> factions);
+  void store_signals(events::body_id_t body_id, std::span<events::signal_t const> signals);
+  void change_mission_status(uint64_t mission_id, info::mission_status_e status);
+  void commit_coalesced(database_storage_t & db);
+  ///\brief queues loading of systems not prefetched yet, current system is skipped
+  void prefetch(std::span<uint64_t const> system_addresses);
+  void prefetch_route();
+  ///\brief removes and returns system loaded ahead
+  [[nodiscard]]
+  auto take_prefetched(uint64_t system_address) -> std::optional<star_system_t>;
   };
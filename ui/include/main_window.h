@@ -42,8 +42,6 @@ public:
   QPointer<ship_loadout_window_t> ship_view_;
   QPointer<mission_window_t> mission_view_;
   QPointer<route_window_t> route_view_;
-  
-  fs::path file_to_monitor{};
 
   QMdiArea * mdi_area_{nullptr};
 
@@ -52,6 +50,9 @@ public:
 
   auto closeEvent(QCloseEvent * event) -> void override;
 
+  ///\brief starts journal processing, database has to be opened before as tailing resumes from its checkpoint
+  auto start_worker() -> void;
+
 private:
   auto background_worker(std::stop_token stoken) -> void;
 
@@ -16,44 +16,16 @@ static auto new_system_def(uint64_t system_address, std::string_view name, std::
   };
   }
 
-auto process_factions(database_storage_t & db, std::span<events::faction_info_t> factions)
-  -> std::vector<info::faction_info_t>
+///\brief factions of system for ui, database is updated by queued sync_factions
+static auto native_factions(std::span<events::faction_info_t const> factions) -> std::vector<info::faction_info_t>
   {
   std::vector<info::faction_info_t> result;
   result.reserve(factions.size());
-
-  for(events::faction_info_t & f: factions)
-    {
-    info::faction_info_t new_faction_data{info::to_native(std::move(f))};
-    auto res{db.load_faction(new_faction_data.name)};
-    if(not res)
-      spdlog::error("failed to load faction info for {}", new_faction_data.name);
-    else if(not *res)
-      {
-      // no data add
-      spdlog::info("adding faction {}", new_faction_data.name);
-      if(auto updres{db.update_faction_info(new_faction_data)}; not updres)
-        spdlog::error("failed to add faction data for {}", new_faction_data.name);
-      auto oidres{db.faction_oid(new_faction_data.name)};
-      if(oidres and *oidres)
-        new_faction_data.oid = int32_t(**oidres);
-      }
-    else
-      {
-      info::faction_info_t old_faction_data{std::move(**res)};
-      new_faction_data.oid = old_faction_data.oid;
-      if(old_faction_data != new_faction_data)
-        {
-        spdlog::info("updating faction {}", new_faction_data.name);
-        if(auto updres{db.update_faction_info(new_faction_data)}; not updres)
-          spdlog::error("failed to update faction data for {}", new_faction_data.name);
-        }
-      }
-    result.emplace_back(std::move(new_faction_data));
-    }
+  for(events::faction_info_t const & f: factions)
+    result.emplace_back(info::to_native(f));
   return result;
   }
-  
+
 void current_state_t::route_system_visited(uint64_t system_address)
 {
   auto it{std::ranges::find( route_, system_address, [](info::route_item_t const & rt ) -> uint64_t{
@@ -68,8 +40,9 @@ void current_state_t::route_system_visited(uint64_t system_address)
         itb->visited = true;
   }
 }
-void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_holder_t && payload)
+void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_holder_t const & payload)
   {
+  // in memory state is updated and ui notified immediately, database writes are applied behind by storage_
   if(nullptr != parent->jlw_)
     {
     bool update_system{};
@@ -77,13 +50,17 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
     bool update_mission_info{};
     bool route_changed{};
     std::visit(
-      [&](auto && event)
+      [&](auto const & event)
       {
         auto f_route_progress = [&](uint64_t system_address)
         {
           route_changed = true;
           current_system_address_ = system_address;
           route_system_visited(system_address);
+          // current system is written from now on, copy loaded ahead or still loading would get stale
+          std::lock_guard lock{prefetch_mtx_};
+          prefetched_.erase(system_address);
+          ++prefetch_epoch_;
         };
         
         using T = std::decay_t<decltype(event)>;
@@ -91,23 +68,31 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           {
           if(event.JumpType == events::jump_type_e::Hyperspace)
             {
-            auto res{db_.load_system(*event.SystemAddress)};
-            if(not res) [[unlikely]]
+            // system loaded ahead during countdown is swapped in without waiting for storage thread
+            if(std::optional ready{take_prefetched(*event.SystemAddress)}; ready)
+              system = std::move(*ready);
+            else if(auto res{load_system(*event.SystemAddress)}; not res) [[unlikely]]
               {
-              spdlog::error("error loading system {} {}", *event.SystemAddress, *event.StarSystem);
-              system = new_system_def(*event.SystemAddress, *event.StarSystem, *event.StarClass);
+              spdlog::error("error loading system {} {}", *event.SystemAddress, event.StarSystem);
+              system = new_system_def(*event.SystemAddress, event.StarSystem, event.StarClass);
               }
             else if(std::optional loaded{std::move(*res)}; loaded)
               system = std::move(*loaded);
             else
               {
-              system = new_system_def(*event.SystemAddress, *event.StarSystem, *event.StarClass);
-              if(auto res2{db_.store(system)}; not res2) [[unlikely]]
-                spdlog::error("error string system {} {}", system.system_address, system.star_type);
+              system = new_system_def(*event.SystemAddress, event.StarSystem, event.StarClass);
+              storage_.push(
+                [system = system](database_storage_t & db)
+                {
+                  if(auto res2{db.store(system)}; not res2) [[unlikely]]
+                    spdlog::error("error string system {} {}", system.system_address, system.star_type);
+                }
+              );
               }
             system_factions.clear();
             update_system = true;
             f_route_progress(*event.SystemAddress);
+            prefetch_route();
             }
           }
         else if constexpr(std::same_as<T, events::location_t>)
@@ -115,7 +100,7 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           // after reloading game start at this system
           buffered_signals.clear();
 
-          if(auto res{db_.load_system(event.SystemAddress)}; not res) [[unlikely]]
+          if(auto res{load_system(event.SystemAddress)}; not res) [[unlikely]]
             {
             spdlog::error("error loading system {} {}", event.SystemAddress, event.StarSystem);
             system = new_system_def(event.SystemAddress, event.StarSystem, {});
@@ -126,20 +111,24 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             if(system.system_location != event.StarPos)
               {
               system.system_location = event.StarPos;
-              if(auto res{db_.store_system_location(system.system_address, system.system_location)}; not res)
-                spdlog::error("failed to store system location {}", system.system_address);
+              store_system_location();
               }
             }
           else
             {
             system = new_system_def(event.SystemAddress, event.StarSystem, {});
             system.system_location = event.StarPos;
-            if(auto res2{db_.store(system)}; not res2) [[unlikely]]
-              spdlog::error("error string system {} {}", event.SystemAddress, event.StarSystem);
+            storage_.push(
+              [system = system](database_storage_t & db)
+              {
+                if(auto res2{db.store(system)}; not res2) [[unlikely]]
+                  spdlog::error("error string system {} {}", system.system_address, system.name);
+              }
+            );
             }
           // add/update factions database
           if(not event.Factions.empty())
-            system_factions = process_factions(db_, event.Factions);
+            store_factions(event.Factions);
           f_route_progress(event.SystemAddress);
           update_system = true;
           }
@@ -150,14 +139,13 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           else if(system.system_location != event.StarPos)
             {
             system.system_location = event.StarPos;
-            if(auto res{db_.store_system_location(system.system_address, system.system_location)}; not res)
-              spdlog::error("failed to store system location {}", system.system_address);
+            store_system_location();
             }
           jump_info = event;
           ship_loadout.FuelLevel = event.FuelLevel;
 
           if(not event.Factions.empty())
-            system_factions = process_factions(db_, event.Factions);
+            store_factions(event.Factions);
 
           f_route_progress(event.SystemAddress);
           update_system = true;
@@ -166,6 +154,7 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
         else if constexpr(std::same_as<T, events::fsd_target_t>)
           {
           next_target = event;
+          prefetch({&event.SystemAddress, 1});
           update_system = true;
           }
 
@@ -175,13 +164,12 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           if(it != system.bodies.end())
             {
             planet_details_t & details{std::get<planet_details_t>(it->details)};
-            details.signals_ = std::move(event.Signals);
-            if(auto res{db_.store(system.system_address, event.BodyID, details.signals_)}; not res)
-              spdlog::error("failed to store signal for {}: {}", system.system_address, event.BodyID);
+            details.signals_ = event.Signals;
+            store_signals(event.BodyID, details.signals_);
             }
           else
             {
-            buffered_signals.emplace_back(event.BodyID, std::move(event.Signals));
+            buffered_signals.emplace_back(event.BodyID, event.Signals);
             }
           update_system = true;
           }
@@ -192,9 +180,8 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             if(auto it{system.ring_by_id(event.BodyID)}; it != system.rings.end())
               {
               ring_t & ring{*it};
-              ring.signals_ = std::move(event.Signals);
-              if(auto res{db_.store(system.system_address, event.BodyID, ring.signals_)}; not res)
-                spdlog::error("failed to store signals for ring {}: {}", system.system_address, event.BodyID);
+              ring.signals_ = event.Signals;
+              store_signals(event.BodyID, ring.signals_);
               }
             else
               spdlog::error("ring was not found for {}: {} {}", system.system_address, event.BodyID, event.BodyName);
@@ -204,27 +191,38 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             planet_details_t & details{std::get<planet_details_t>(it->details)};
             if(details.signals_.size() != event.Signals.size())
               {
-              details.signals_ = std::move(event.Signals);
-              if(auto res{db_.store(system.system_address, event.BodyID, details.signals_)}; not res)
-                spdlog::error("failed to store signal for {}: {}", system.system_address, event.BodyID);
+              details.signals_ = event.Signals;
+              store_signals(event.BodyID, details.signals_);
               }
             if(details.genuses_.size() != event.Genuses.size())
               {
-              details.genuses_ = std::move(event.Genuses);
-              if(auto res{db_.store(system.system_address, event.BodyID, details.genuses_)}; not res)
-                spdlog::error("failed to store genuses_ for {}: {}", system.system_address, event.BodyID);
+              details.genuses_ = event.Genuses;
+              storage_.push(
+                [system_address = system.system_address, body_id = event.BodyID, genuses = details.genuses_](
+                  database_storage_t & db
+                )
+                {
+                  if(auto res{db.store(system_address, body_id, genuses)}; not res)
+                    spdlog::error("failed to store genuses_ for {}: {}", system_address, body_id);
+                }
+              );
               }
             }
           else
-            buffered_signals.emplace_back(event.BodyID, std::move(event.Signals), std::move(event.Genuses));
+            buffered_signals.emplace_back(event.BodyID, event.Signals, event.Genuses);
 
           update_system = true;
           }
         else if constexpr(std::same_as<T, events::fss_all_bodies_found_t>)
           {
           system.fss_complete = true;
-          if(auto res{db_.store_fss_complete(system.system_address)}; not res) [[unlikely]]
-            spdlog::error("failed to update fss scan complete for {}", system.system_address);
+          storage_.push(
+            [system_address = system.system_address](database_storage_t & db)
+            {
+              if(auto res{db.store_fss_complete(system_address)}; not res) [[unlikely]]
+                spdlog::error("failed to update fss scan complete for {}", system_address);
+            }
+          );
           }
         else if constexpr(std::same_as<T, events::scan_bary_centre_t>)
           {
@@ -248,7 +246,7 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
 
           if(auto it{system.body_by_id(event.BodyID)}; it == system.bodies.end())
             {
-            system.bodies.emplace_back(to_body(std::move(event)));
+            system.bodies.emplace_back(to_body(event));
             body_t & body{system.bodies.back()};
             std::visit(
               [&]<typename U>(U & details)
@@ -268,8 +266,13 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
               },
               body.details
             );
-            if(auto res{db_.store(system.system_address, body)}; not res)
-              spdlog::error("failed to store body {}: {}", system.system_address, body.name);
+            storage_.push(
+              [system_address = system.system_address, system_name = system.name, body = body](database_storage_t & db)
+              {
+                if(auto res{db.store(system_address, system_name, body)}; not res)
+                  spdlog::error("failed to store body {}: {}", system_address, body.name);
+              }
+            );
 
             // handle rings
             if(not event.Rings.empty())
@@ -278,7 +281,7 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
               std::ranges::transform(
                 event.Rings,
                 std::back_inserter(rings),
-                [&event](events::ring_t & ring) -> ring_t
+                [&event](events::ring_t const & ring) -> ring_t
                 {
                   return ring_t{
                     .name = std::string(stralgo::right(ring.Name, 6)),
@@ -291,10 +294,16 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
                   };
                 }
               );
-              if(auto res{db_.store(system.system_address, rings)}; not res)
-                spdlog::error("failed to store rings for {}: {}", system.system_address, body.name);
-              else
-                system.rings.insert(system.rings.end(), rings.begin(), rings.end());
+              system.rings.insert(system.rings.end(), rings.begin(), rings.end());
+              storage_.push(
+                [system_address = system.system_address, name = body.name, rings = std::move(rings)](
+                  database_storage_t & db
+                )
+                {
+                  if(auto res{db.store(system_address, rings)}; not res)
+                    spdlog::error("failed to store rings for {}: {}", system_address, name);
+                }
+              );
               }
             }
 
@@ -310,9 +319,18 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             if(auto it{system.body_by_name(planet_name)}; it != system.bodies.end())
               {
               events::body_id_t const parent_planet_id{it->body_id};
-              if(auto res{db_.store_ring_body_id(system.system_address, parent_planet_id, ring_name, event.BodyID)};
-                 not res) [[unlikely]]
-                spdlog::error("failed to update ring body id for {}:{}", system.system_address, event.BodyName);
+              storage_.push(
+                [system_address = system.system_address,
+                 parent_planet_id,
+                 ring_name = std::string{ring_name},
+                 body_id = event.BodyID,
+                 body_name = event.BodyName](database_storage_t & db)
+                {
+                  if(auto res{db.store_ring_body_id(system_address, parent_planet_id, ring_name, body_id)}; not res)
+                    [[unlikely]]
+                    spdlog::error("failed to update ring body id for {}:{}", system_address, body_name);
+                }
+              );
 
               if(auto itr{std::ranges::find_if(
                    system.rings,
@@ -335,8 +353,13 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             {
             planet_details_t & details{std::get<planet_details_t>(it->details)};
             details.mapped = true;
-            if(auto res{db_.store_dss_complete(system.system_address, event.BodyID)}; not res) [[unlikely]]
-              spdlog::error("failed to update dss scan complete for {}:{}", system.system_address, event.BodyID);
+            storage_.push(
+              [system_address = system.system_address, body_id = event.BodyID](database_storage_t & db)
+              {
+                if(auto res{db.store_dss_complete(system_address, body_id)}; not res) [[unlikely]]
+                  spdlog::error("failed to update dss scan complete for {}:{}", system_address, body_id);
+              }
+            );
             }
           update_system = true;
           }
@@ -348,14 +371,14 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
         else if constexpr(std::same_as<T, events::loadout_t>)
           {
           ship_loadout = ship_loadout_t{
-            .Ship = std::move(event.Ship),
+            .Ship = event.Ship,
             .ShipID = event.ShipID,
-            .ShipName = std::move(event.ShipName),
-            .ShipIdent = std::move(event.ShipIdent),
+            .ShipName = event.ShipName,
+            .ShipIdent = event.ShipIdent,
             .HullHealth = event.HullHealth,
             .CargoCapacity = event.CargoCapacity,
             .FuelCapacity = event.FuelCapacity,
-            .Modules = std::move(event.Modules)
+            .Modules = event.Modules
           };
           std::ranges::sort(
             ship_loadout.Modules, std::less{}, [](events::module_t const & mod) -> uint8_t { return mod.Priority; }
@@ -369,78 +392,91 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           }
         else if constexpr(std::same_as<T, events::mission_accepted_t>)
           {
-          // in case restarted multiple times with same log prevent adding same missions
-          if(auto res{db_.mission_exists(event.MissionID)}; res and not *res)
+          info::mission_t mission{
+            .mission_id = event.MissionID,
+            .status = info::mission_status_e::accepted,
+            .expiry = event.Expiry,
+
+            .faction = event.Faction,
+            .type = event.Name,
+            .description = event.LocalisedName,
+            .reward = event.Reward,
+            .target = event.Target,
+            .target_type = event.TargetType_Localised,
+            .target_faction = event.TargetFaction,
+            .destination_system = event.DestinationSystem,
+            .destination_station = event.DestinationStation,
+            .destination_settlement = event.DestinationSettlement,
+
+            .count = event.Count,
+            .kill_count = event.KillCount,
+            .passenger_count = event.PassengerCount
+          };
+          if(std::ranges::find(active_missions, event.MissionID, &info::mission_t::mission_id) == active_missions.end())
+            active_missions.push_back(mission);
+          storage_.push(
+            [mission = std::move(mission)](database_storage_t & db)
             {
-            info::mission_t mission{
-              .mission_id = event.MissionID,
-              .status = info::mission_status_e::accepted,
-              .expiry = event.Expiry,
-
-              .faction = event.Faction,
-              .type = event.Name,
-              .description = event.LocalisedName,
-              .reward = event.Reward,
-              .target = event.Target,
-              .target_type = event.TargetType_Localised,
-              .target_faction = event.TargetFaction,
-              .destination_system = event.DestinationSystem,
-              .destination_station = event.DestinationStation,
-              .destination_settlement = event.DestinationSettlement,
-
-              .count = event.Count,
-              .kill_count = event.KillCount,
-              .passenger_count = event.PassengerCount
-            };
-            if(auto res{db_.store(mission)}; not res) [[unlikely]]
-              spdlog::error("failed to store mission details for {}", event.MissionID);
+              // in case restarted multiple times with same log prevent adding same missions
+              if(auto res{db.mission_exists(mission.mission_id)}; res and not *res)
+                if(auto res2{db.store(mission)}; not res2) [[unlikely]]
+                  spdlog::error("failed to store mission details for {}", mission.mission_id);
             }
-          load_missions();
+          );
           update_mission_info = true;
           }
         else if constexpr(std::same_as<T, events::mission_completed_t>)
           {
-          if(auto res{db_.change_mission_status(event.MissionID, info::mission_status_e::completed)}; not res)
-            [[unlikely]]
-            [[unlikely]] spdlog::error("failed to change mission status for {}", event.MissionID);
-          load_missions();
+          change_mission_status(event.MissionID, info::mission_status_e::completed);
           update_mission_info = true;
           }
         else if constexpr(std::same_as<T, events::mission_abandoned_t>)
           {
-          if(auto res{db_.change_mission_status(event.MissionID, info::mission_status_e::abandoned)}; not res)
-            [[unlikely]]
-            [[unlikely]] spdlog::error("failed to change mission status for {}", event.MissionID);
-          load_missions();
+          change_mission_status(event.MissionID, info::mission_status_e::abandoned);
           update_mission_info = true;
           }
         else if constexpr(std::same_as<T, events::mission_failed_t>)
           {
-          if(auto res{db_.change_mission_status(event.MissionID, info::mission_status_e::failed)}; not res) [[unlikely]]
-            [[unlikely]] spdlog::error("failed to change mission status for {}", event.MissionID);
-          load_missions();
+          change_mission_status(event.MissionID, info::mission_status_e::failed);
           update_mission_info = true;
           }
         else if constexpr(std::same_as<T, events::mission_redirected_t>)
           {
-          if(auto res{db_.redirect_mission(
-               event.MissionID, event.NewDestinationSystem, event.NewDestinationStation, event.NewDestinationSettlement
-             )};
-             not res) [[unlikely]]
-            spdlog::error("failed to change mission status for {}", event.MissionID);
-          load_missions();
+          if(auto it{std::ranges::find(active_missions, event.MissionID, &info::mission_t::mission_id)};
+             it != active_missions.end())
+            {
+            it->status = info::mission_status_e::redirected;
+            it->redirected_system = event.NewDestinationSystem;
+            it->redirected_station = event.NewDestinationStation;
+            it->redirected_settlement = event.NewDestinationSettlement;
+            }
+          storage_.push(
+            [mission_id = event.MissionID,
+             system = event.NewDestinationSystem,
+             station = event.NewDestinationStation,
+             settlement = event.NewDestinationSettlement](database_storage_t & db)
+            {
+              if(auto res{db.redirect_mission(mission_id, system, station, settlement)}; not res) [[unlikely]]
+                spdlog::error("failed to change mission status for {}", mission_id);
+            }
+          );
           update_mission_info = true;
           }
         else if constexpr(std::same_as<T, events::missions_t>)
           {
-          for(events::mission_failed_t const & mission: event.Failed)
-            if(auto res{db_.change_mission_status(mission.MissionID, info::mission_status_e::failed)}; not res)
-              [[unlikely]]
-              spdlog::warn("failed to change mission status for {}", mission.MissionID);
-          for(events::mission_completed_t const & mission: event.Complete)
-            if(auto res{db_.change_mission_status(mission.MissionID, info::mission_status_e::completed)}; not res)
-              [[unlikely]]
-              spdlog::warn("failed to change mission status for {}", mission.MissionID);
+          storage_.push(
+            [failed = event.Failed, complete = event.Complete](database_storage_t & db)
+            {
+              for(events::mission_failed_t const & mission: failed)
+                if(auto res{db.change_mission_status(mission.MissionID, info::mission_status_e::failed)}; not res)
+                  [[unlikely]]
+                  spdlog::warn("failed to change mission status for {}", mission.MissionID);
+              for(events::mission_completed_t const & mission: complete)
+                if(auto res{db.change_mission_status(mission.MissionID, info::mission_status_e::completed)}; not res)
+                  [[unlikely]]
+                  spdlog::warn("failed to change mission status for {}", mission.MissionID);
+            }
+          );
 
           // called on startup so we are loading accepted missions
           load_missions();
@@ -455,13 +491,13 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
           std::ranges::transform(
             event.Route,
             std::back_inserter(route_),
-            [&prev](events::nav_route_t::item_t & ri) -> info::route_item_t
+            [&prev](events::nav_route_t::item_t const & ri) -> info::route_item_t
             {
               info::route_item_t result{
-                .system = std::move(ri.StarSystem),
+                .system = ri.StarSystem,
                 .system_address = ri.SystemAddress,
                 .star_location = ri.StarPos,
-                .star_class = std::move(ri.StarClass),
+                .star_class = ri.StarClass,
                 .distance = info::distance(ri.StarPos, prev),
                 .visited{}
               };
@@ -470,11 +506,22 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
             }
           );}
           route_system_visited(current_system_address_);
+            {
+            std::lock_guard lock{prefetch_mtx_};
+            prefetched_.clear();
+            ++prefetch_epoch_;
+            }
+          prefetch_route();
           route_changed = true;
           }
         else if constexpr(std::same_as<T, events::nav_route_clear_t>)
           {
           route_.clear();
+            {
+            std::lock_guard lock{prefetch_mtx_};
+            prefetched_.clear();
+            ++prefetch_epoch_;
+            }
           route_changed = true;
           }
       },
@@ -495,7 +542,7 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
     }
       {
       std::lock_guard lock(buffer_mtx_);
-      event_buffer_.push_back(std::move(payload));
+      event_buffer_.push_back(payload);
       }
     QMetaObject::invokeMethod(
       parent->jlw_,
@@ -551,8 +598,225 @@ void current_state_t::handle(std::chrono::sys_seconds timestamp, events::event_h
 
 void current_state_t::load_missions()
   {
-  if(auto res{db_.load_missions()}; not res) [[unlikely]]
+  if(auto res{storage_.call([](database_storage_t & db) { return db.load_missions(); })}; not res) [[unlikely]]
     spdlog::warn("failed to load missions status");
   else
     active_missions = std::move(*res);
   }
+
+auto current_state_t::load_system(uint64_t system_address) -> expected_ec<std::optional<star_system_t>>
+  {
+  // waits for queued writes so system stored before is loaded completely
+  return storage_.call([system_address](database_storage_t & db) { return db.load_system(system_address); });
+  }
+
+void current_state_t::store_system_location()
+  {
+  storage_.push(
+    [system_address = system.system_address, location = system.system_location](database_storage_t & db)
+    {
+      if(auto res{db.store_system_location(system_address, location)}; not res)
+        spdlog::error("failed to store system location {}", system_address);
+    }
+  );
+  }
+
+void current_state_t::store_factions(std::span<events::faction_info_t const> factions)
+  {
+  system_factions = native_factions(factions);
+  storage_.push(
+    [factions = system_factions](database_storage_t & db) mutable
+    {
+      if(auto res{db.sync_factions(factions)}; not res) [[unlikely]]
+        spdlog::error("failed to store factions of system");
+    }
+  );
+  }
+
+void current_state_t::store_signals(events::body_id_t body_id, std::span<events::signal_t const> signals)
+  {
+  storage_.push(
+    [system_address = system.system_address, body_id, signals = std::vector(signals.begin(), signals.end())](
+      database_storage_t & db
+    )
+    {
+      if(auto res{db.store(system_address, body_id, signals)}; not res)
+        spdlog::error("failed to store signal for {}: {}", system_address, body_id);
+    }
+  );
+  }
+
+void current_state_t::change_mission_status(uint64_t mission_id, info::mission_status_e status)
+  {
+  // only accepted and redirected missions are active
+  std::erase_if(active_missions, [mission_id](info::mission_t const & m) { return m.mission_id == mission_id; });
+  storage_.push(
+    [mission_id, status](database_storage_t & db)
+    {
+      if(auto res{db.change_mission_status(mission_id, status)}; not res) [[unlikely]]
+        spdlog::error("failed to change mission status for {}", mission_id);
+    }
+  );
+  }
+
+void current_state_t::prefetch(std::span<uint64_t const> system_addresses)
+  {
+  std::vector<uint64_t> addresses;
+  uint64_t epoch;
+    {
+    std::lock_guard lock{prefetch_mtx_};
+    for(uint64_t address: system_addresses)
+      if(address != system.system_address and not prefetched_.contains(address))
+        addresses.push_back(address);
+    epoch = prefetch_epoch_;
+    }
+  if(addresses.empty())
+    return;
+  auto task = [this, addresses = std::move(addresses), epoch](database_storage_t & db)
+  {
+    for(uint64_t address: addresses)
+      if(auto res{db.load_system(address)}; res and *res)
+        {
+        std::lock_guard lock{prefetch_mtx_};
+        // jump started meanwhile, loaded system may be written by storage thread already
+        if(epoch != prefetch_epoch_)
+          return;
+        prefetched_.insert_or_assign(address, std::move(**res));
+        }
+  };
+  if(not readers_.is_open())
+    {
+    // queued behind writes so loaded systems contain everything stored before
+    storage_.push(std::move(task));
+    return;
+    }
+  // read only connections see only committed writes, so task is handed over once writes queued before it and the
+  // coalescing transaction are committed
+  storage_.push(
+    [this, task = std::move(task)](database_storage_t & db) mutable
+    {
+      commit_coalesced(db);
+      storage_.after_commit([this, task = std::move(task)]() mutable { readers_.push(std::move(task)); });
+    }
+  );
+  }
+
+void current_state_t::prefetch_route()
+  {
+  std::vector<uint64_t> addresses;
+  for(info::route_item_t const & item: route_)
+    {
+    if(addresses.size() == prefetch_depth_)
+      break;
+    if(not item.visited and item.system_address != current_system_address_)
+      addresses.push_back(item.system_address);
+    }
+  prefetch(addresses);
+  }
+
+auto current_state_t::take_prefetched(uint64_t system_address) -> std::optional<star_system_t>
+  {
+  std::lock_guard lock{prefetch_mtx_};
+  auto node{prefetched_.extract(system_address)};
+  if(node.empty())
+    return std::nullopt;
+  return std::move(node.mapped());
+  }
+
+auto current_state_t::resume() -> std::optional<journal_position_t>
+  {
+  auto res{storage_.call([](database_storage_t & db) { return db.load_last_checkpoint(); })};
+  if(not res) [[unlikely]]
+    {
+    spdlog::warn("failed to load journal checkpoint");
+    return std::nullopt;
+    }
+  if(not *res)
+    return std::nullopt;
+
+  journal_checkpoint_t const & checkpoint{**res};
+  if(checkpoint.system_address != 0)
+    {
+    if(auto sysres{load_system(checkpoint.system_address)}; sysres and *sysres)
+      {
+      system = std::move(**sysres);
+      current_system_address_ = checkpoint.system_address;
+      }
+    else
+      spdlog::warn("failed to restore system {} from checkpoint", checkpoint.system_address);
+    }
+  load_missions();
+  last_event_timestamp_ = checkpoint.last_event;
+  spdlog::info("resuming {} at offset {}", checkpoint.journal, checkpoint.offset);
+  return journal_position_t{.journal = fs::path{journal_dir_path_} / checkpoint.journal, .offset = checkpoint.offset};
+  }
+
+void current_state_t::store_checkpoint(journal_position_t const & position)
+  {
+  std::error_code ec;
+  uint64_t const size{fs::file_size(position.journal, ec)};
+  journal_checkpoint_t checkpoint{
+    .journal = position.journal.filename().string(),
+    .file_size = ec ? 0u : size,
+    .mtime = file_mtime_seconds(position.journal),
+    .offset = position.offset,
+    .last_event = last_event_timestamp_,
+    .system_address = system.system_address
+  };
+  // queued after writes of delivered lines so checkpoint never points past data that is not stored
+  storage_.push(
+    [checkpoint = std::move(checkpoint)](database_storage_t & db)
+    {
+      if(auto res{db.store(checkpoint)}; not res) [[unlikely]]
+        spdlog::warn("failed to store checkpoint for {}", checkpoint.journal);
+    }
+  );
+  }
+
+void current_state_t::begin_chunk()
+  {
+  if(commit_window_.count() == 0)
+    return;
+  storage_.push(
+    [this](database_storage_t & db)
+    {
+      if(coalescing_)
+        return;
+      if(auto res{db.begin_transaction()}; not res) [[unlikely]]
+        spdlog::warn("failed to begin transaction");
+      else
+        {
+        coalescing_ = true;
+        transaction_start_ = std::chrono::steady_clock::now();
+        }
+    }
+  );
+  }
+
+void current_state_t::end_chunk()
+  {
+  if(commit_window_.count() == 0)
+    return;
+  storage_.push(
+    [this](database_storage_t & db)
+    {
+      if(coalescing_ and std::chrono::steady_clock::now() - transaction_start_ >= commit_window_)
+        commit_coalesced(db);
+    }
+  );
+  }
+
+void current_state_t::flush_pending()
+  {
+  storage_.push([this](database_storage_t & db) { commit_coalesced(db); });
+  }
+
+void current_state_t::commit_coalesced(database_storage_t & db)
+  {
+  if(not coalescing_)
+    return;
+  coalescing_ = false;
+  // storage thread batch scope is still open, writes are committed when it ends
+  if(auto res{db.commit_transaction()}; not res) [[unlikely]]
+    spdlog::warn("failed to commit journal events");
+  }
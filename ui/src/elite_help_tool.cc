@@ -13,6 +13,7 @@
 #include <qprogressbar.h>
 #include <qscrollarea.h>
 #include <qgroupbox.h>
+#include <spdlog/spdlog.h>
 
 // Struktura reprezentująca definicję przycisku narzędziowego
 struct tool_definition_t
@@ -29,7 +30,10 @@ main_window_t::main_window_t(std::string db_path, std::string journal_path, QWid
   {
   setup_ui();
   load_settings();
+  }
 
+auto main_window_t::start_worker() -> void
+  {
   worker_thread_ = std::jthread([this](std::stop_token stoken) { background_worker(stoken); });
   }
 
@@ -137,6 +141,9 @@ auto main_window_t::load_settings() -> void
   {
   QSettings settings("ebasoft", "EliteHelpTool");
 
+  // database writes of live events may be coalesced, 0 commits every event
+  state_.commit_window_ = std::chrono::milliseconds{settings.value("database/commit_window_ms", 0).toInt()};
+
   settings.beginGroup("main_window");
   if(auto geo = settings.value("geometry"); geo.isValid())
     restoreGeometry(geo.toByteArray());
@@ -185,8 +192,19 @@ auto main_window_t::load_settings() -> void
 
 auto main_window_t::background_worker(std::stop_token stoken) -> void
   {
-  file_to_monitor = *find_latest_journal("journal-dir");
-  tail_file(file_to_monitor, std::bind_front(&generic_state_t::discovery, &state_), stoken);
+  // continue after last event stored in database instead of replaying whole latest journal
+  tail_options_t const options{
+    .on_progress = std::bind_front(&current_state_t::store_checkpoint, &state_),
+    .start = state_.resume(),
+    .on_idle = std::bind_front(&current_state_t::flush_pending, &state_),
+    .idle_timeout = state_.commit_window_
+  };
+  follow_journals(
+    state_.journal_dir_path_,
+    process_lines_callback{std::bind_front(&generic_state_t::process_lines, &state_)},
+    stoken,
+    options
+  );
   }
 
 auto main(int argc, char * argv[]) -> int
@@ -196,6 +214,9 @@ auto main(int argc, char * argv[]) -> int
   main_window_t window{"ehtdb.sqlite", "journal-dir"};
   if(not window.state_.db_.open())
     return EXIT_FAILURE;
+  if(auto res{window.state_.readers_.open("ehtdb.sqlite", 2)}; not res) [[unlikely]]
+    spdlog::warn("read only connections not available {}", res.error().message());
+  window.start_worker();
 
   window.show();
   return app.exec();
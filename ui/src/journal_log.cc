@@ -38,10 +38,10 @@ elite_event_widget_t<T>::elite_event_widget_t(T const & event, QWidget * parent)
     {
     if(event.JumpType == events::jump_type_e::Hyperspace)
       {
-      planet_value_e const vl{exploration::system_approx_value(*event.StarClass, *event.StarSystem)};
+      planet_value_e const vl{exploration::system_approx_value(event.StarClass, event.StarSystem)};
 
       layout->addWidget(new QLabel("→🌞"));
-      auto * val = new QLabel(qformat("[{}] {}", *event.StarClass, *event.StarSystem));
+      auto * val = new QLabel(qformat("[{}] {}", event.StarClass, event.StarSystem));
       if(planet_value_e::low < vl)
         val->setStyleSheet(value_color(vl).data());
       layout->addWidget(val);
@@ -0,0 +1,399 @@
+#include <databse_storage.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+// Insert throughput of database_storage_t with cached prepared statements.
+// usage: db_bench [bodies] [db_path]
+// without db_path in memory database is used so only statement preparation, binding and sqlite work is measured,
+// load_missions section measures typed column reads of 1000 mission rows,
+// load_system section measures loading of systems with 1, 20, 100 and 500 bodies with and without system cache,
+// scan section streams whole body table through row_cursor_t one row and 256 row batches at a time,
+// factions section compares select and update per faction with cached upsert of sync_factions,
+// spatial section compares radius search by full scan of 100k systems with rtree radius, box and nearest queries,
+// name search section measures prefix and fuzzy full text search over names of those systems and of stored bodies
+// with db_path on disk difference between autocommit and batched transaction shows cost of syncing each write
+
+using namespace std::string_view_literals;
+using bench_clock = std::chrono::steady_clock;
+
+namespace
+  {
+[[nodiscard]]
+auto make_body(uint32_t ix) -> body_t
+  {
+  return body_t{
+    .value = 1000000,
+    .body_id = static_cast<events::body_id_t>(ix % 200),
+    .name = std::format("Oochosy LW-C d14 {}", ix),
+    .details = planet_details_t{
+      .parent_star = 1,
+      .terraform_state = events::terraform_state_e::Terraformable,
+      .planet_class = "High metal content body",
+      .atmosphere = "thick argon rich atmosphere",
+      .atmosphere_type = "ArgonRich",
+      .mass_em = 0.006929,
+      .surface_gravity = 1.763689,
+      .surface_temperature = 956.597717,
+      .rotation_period = 341110.368400,
+    },
+    .orbital_period = 341110.241413
+  };
+  }
+
+///\brief stores system with body_count planets having signals and genuses, then measures load_system
+auto measure_load(database_storage_t & dbs, uint32_t body_count) -> void
+  {
+  star_system_t system{
+    .system_address = 1000000u + body_count,
+    .name = std::format("Load bench {}", body_count),
+    .star_type = "K",
+    .system_location = {},
+    .bary_centre = {},
+    .bodies = {},
+    .rings = {},
+    .fss_complete = true
+  };
+  std::vector<ring_t> rings;
+  for(uint32_t ix{}; ix != body_count; ++ix)
+    {
+    body_t body{make_body(ix)};
+    body.body_id = static_cast<events::body_id_t>(ix);
+    planet_details_t & details{std::get<planet_details_t>(body.details)};
+    details.signals_ = {{.Type_Localised = "Biological", .Count = 2}, {.Type_Localised = "Geological", .Count = 5}};
+    details.genuses_ = {{.Genus_Localised = "Bacterium"}};
+    system.bodies.emplace_back(std::move(body));
+    if(ix % 10 == 0)
+      rings.emplace_back(
+        ring_t{.name = std::format("{} A Ring", ix), .ring_class = "eRingClass_Icy", .parent_body_id = ix}
+      );
+    }
+    {
+    transaction_scope_t const transaction{dbs};
+    if(not dbs.store(system) or not dbs.store(system.system_address, rings))
+      {
+      std::println(stderr, "failed to store system with {} bodies", body_count);
+      return;
+      }
+    }
+
+  uint32_t const loads{std::max(20u, 20000u / body_count)};
+  // without cache every load runs queries, with cache only first load of system does
+  for(std::size_t const capacity: {std::size_t{0}, std::size_t{16}})
+    {
+    dbs.system_cache_.clear();
+    dbs.system_cache_.capacity_ = capacity;
+    std::size_t loaded_bodies{};
+    auto const start{bench_clock::now()};
+    for(uint32_t ix{}; ix != loads; ++ix)
+      if(auto res{dbs.load_system(system.system_address)}; res and *res)
+        loaded_bodies += (*res)->bodies.size();
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    std::println(
+      "load_system{} bodies:{:4} loads:{:6} {:10.1f} us/load{}",
+      capacity != 0 ? " cached"sv : ""sv,
+      body_count,
+      loads,
+      seconds * 1e6 / static_cast<double>(loads),
+      loaded_bodies == std::size_t{body_count} * loads ? ""sv : " incomplete"sv
+    );
+    }
+  }
+
+///\brief stores active missions and measures load_missions which reads timestamps and enums of every row
+auto measure_missions(database_storage_t & dbs, uint32_t count) -> void
+  {
+  auto const expiry{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()) + std::chrono::days{7}};
+    {
+    transaction_scope_t const transaction{dbs};
+    for(uint32_t ix{}; ix != count; ++ix)
+      [[maybe_unused]]
+      auto const res{dbs.store(info::mission_t{
+        .mission_id = 5000000u + ix,
+        .status = info::mission_status_e::accepted,
+        .expiry = expiry,
+        .faction = "Smith's Crew",
+        .type = "Mission_Delivery",
+        .description = std::format("Deliver {} units", ix)
+      })};
+    }
+
+  constexpr uint32_t loads{200};
+  std::size_t loaded{};
+  auto const start{bench_clock::now()};
+  for(uint32_t ix{}; ix != loads; ++ix)
+    if(auto res{dbs.load_missions()}; res)
+      loaded += res->size();
+  double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+  std::println(
+    "load_missions rows:{:6} {:10.1f} us/load {:12.0f} rows/s",
+    loaded / loads,
+    seconds * 1e6 / static_cast<double>(loads),
+    static_cast<double>(loaded) / seconds
+  );
+  }
+
+///\brief faction updates of jumps between systems with 10 factions each, every third jump changes influence
+auto measure_factions(database_storage_t & dbs, uint32_t jumps) -> void
+  {
+  auto const factions_of = [](uint32_t jump) -> std::vector<info::faction_info_t>
+  {
+    std::vector<info::faction_info_t> factions;
+    for(uint32_t ix{}; ix != 10; ++ix)
+      factions.emplace_back(
+        info::faction_info_t{
+          .name = std::format("Faction {}", (jump % 8) * 10 + ix), .influence = 0.1 * static_cast<double>(jump % 3)
+        }
+      );
+    return factions;
+  };
+
+  // former path, select by name then insert or update by oid
+  auto const start{bench_clock::now()};
+  for(uint32_t jump{}; jump != jumps; ++jump)
+    {
+    transaction_scope_t const transaction{dbs};
+    for(info::faction_info_t & faction: factions_of(jump))
+      if(auto res{dbs.load_faction(faction.name)}; res)
+        {
+        if(*res)
+          faction.oid = (*res)->oid;
+        [[maybe_unused]]
+        auto const updres{dbs.update_faction_info(faction)};
+        }
+    }
+  double const select_seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+
+  auto const start_sync{bench_clock::now()};
+  for(uint32_t jump{}; jump != jumps; ++jump)
+    {
+    std::vector<info::faction_info_t> factions{factions_of(jump)};
+    [[maybe_unused]]
+    auto const res{dbs.sync_factions(factions)};
+    }
+  double const sync_seconds{std::chrono::duration<double>(bench_clock::now() - start_sync).count()};
+  std::println(
+    "factions jumps:{:6} select+update:{:8.1f} us/jump sync_factions:{:8.1f} us/jump",
+    jumps,
+    select_seconds * 1e6 / static_cast<double>(jumps),
+    sync_seconds * 1e6 / static_cast<double>(jumps)
+  );
+  }
+
+///\brief full body table scan, memory use does not depend on number of rows
+auto measure_scan(database_storage_t & dbs) -> void
+  {
+  for(std::size_t const batch_size: {std::size_t{1}, std::size_t{256}})
+    {
+    auto cursor{dbs.scan_bodies()};
+    if(not cursor)
+      return;
+    std::vector<system_body_t> batch;
+    std::size_t rows{};
+    auto const start{bench_clock::now()};
+    for(;;)
+      {
+      auto res{cursor->next_batch(batch, batch_size)};
+      if(not res or *res == 0)
+        break;
+      rows += *res;
+      }
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    std::println(
+      "scan_bodies batch:{:4} rows:{:8} {:12.0f} rows/s", batch_size, rows, static_cast<double>(rows) / seconds
+    );
+    }
+  }
+
+///\brief stores count systems spread over 1000 ly cube and measures spatial queries around random centers
+auto measure_spatial(database_storage_t & dbs, uint32_t count) -> void
+  {
+  std::mt19937_64 rng{42};
+  std::uniform_real_distribution<double> coordinate{-500., 500.};
+  auto const random_location = [&] { return info::space_location_t{coordinate(rng), coordinate(rng), coordinate(rng)}; };
+    {
+    transaction_scope_t const transaction{dbs};
+    for(uint32_t ix{}; ix != count; ++ix)
+      [[maybe_unused]]
+      auto const res{dbs.store(star_system_t{
+        .system_address = 9000000000u + ix,
+        .name = std::format("Spatial bench {}", ix),
+        .star_type = "M",
+        .system_location = random_location(),
+        .bary_centre = {},
+        .bodies = {},
+        .rings = {},
+        .fss_complete = false
+      })};
+    }
+
+  constexpr double radius{50.};
+  auto const measure = [&](std::string_view name, uint32_t queries, auto && query)
+  {
+    std::size_t found{};
+    auto const start{bench_clock::now()};
+    for(uint32_t ix{}; ix != queries; ++ix)
+      found += query(random_location());
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    std::println(
+      "{:16} systems:{:8} {:10.1f} us/query {:8.1f} found/query",
+      name,
+      count,
+      seconds * 1e6 / static_cast<double>(queries),
+      static_cast<double>(found) / static_cast<double>(queries)
+    );
+  };
+  // former way, every system is read and its distance computed
+  measure(
+    "scan within",
+    10,
+    [&](info::space_location_t const & center) -> std::size_t
+    {
+      std::size_t found{};
+      if(auto cursor{dbs.scan_systems()}; cursor)
+        for(star_system_t const & system: *cursor)
+          if(info::distance(center, system.system_location) <= radius)
+            ++found;
+      return found;
+    }
+  );
+  measure(
+    "systems_within",
+    1000,
+    [&](info::space_location_t const & center) -> std::size_t
+    {
+      auto res{dbs.systems_within(center, radius)};
+      return res ? res->size() : 0u;
+    }
+  );
+  measure(
+    "systems_in_box",
+    1000,
+    [&](info::space_location_t const & center) -> std::size_t
+    {
+      auto res{dbs.systems_in_box(
+        {center[0] - radius, center[1] - radius, center[2] - radius},
+        {center[0] + radius, center[1] + radius, center[2] + radius}
+      )};
+      return res ? res->size() : 0u;
+    }
+  );
+  measure(
+    "nearest_systems",
+    1000,
+    [&](info::space_location_t const & center) -> std::size_t
+    {
+      auto res{dbs.nearest_systems(center, 10)};
+      return res ? res->size() : 0u;
+    }
+  );
+  }
+
+///\brief prefix and fuzzy searches of names stored by measure_spatial, fuzzy text has swapped letters
+auto measure_name_search(database_storage_t & dbs) -> void
+  {
+  auto const measure = [&](std::string_view name, auto && search)
+  {
+    constexpr uint32_t queries{1000};
+    std::size_t found{};
+    auto const start{bench_clock::now()};
+    for(uint32_t ix{}; ix != queries; ++ix)
+      found += search(ix * 97u);
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    std::println(
+      "{:20} {:10.1f} us/query {:8.1f} found/query",
+      name,
+      seconds * 1e6 / static_cast<double>(queries),
+      static_cast<double>(found) / static_cast<double>(queries)
+    );
+  };
+  measure(
+    "search_names",
+    [&](uint32_t ix) -> std::size_t
+    {
+      auto res{dbs.search_names(std::format("spat ben {}", ix))};
+      return res ? res->size() : 0u;
+    }
+  );
+  measure(
+    "search_names_fuzzy",
+    [&](uint32_t ix) -> std::size_t
+    {
+      auto res{dbs.search_names_fuzzy(std::format("Spatail bench {}", ix))};
+      return res ? res->size() : 0u;
+    }
+  );
+  }
+
+auto report(std::string_view name, uint32_t count, bench_clock::duration elapsed) -> void
+  {
+  double const seconds{std::chrono::duration<double>(elapsed).count()};
+  std::println(
+    "{:10} count:{:8} time:{:8.3f}s {:12.0f} inserts/s", name, count, seconds, static_cast<double>(count) / seconds
+  );
+  }
+  }  // namespace
+
+auto main(int argc, char ** argv) -> int
+  {
+  uint32_t bodies{20000};
+  std::string db_path{":memory:"};
+  if(argc > 1)
+    bodies = static_cast<uint32_t>(std::stoul(argv[1]));
+  if(argc > 2)
+    {
+    db_path = argv[2];
+    if(std::filesystem::exists(db_path))
+      std::filesystem::remove(db_path);
+    }
+
+  database_storage_t dbs{db_path};
+  if(auto res{dbs.open()}; not res)
+    {
+    std::println(stderr, "can not open {} {}", db_path, res.error().message());
+    return 1;
+    }
+
+  // autocommit pays for journal sync of every row, batched run groups all rows into single transaction
+  constexpr uint64_t system_address{3384199352978};
+  events::signal_t const signal{.Type_Localised = "Biological", .Count = 3};
+  for(bool const batched: {false, true})
+    {
+    std::optional<transaction_scope_t> transaction;
+    if(batched)
+      transaction.emplace(dbs);
+
+    uint64_t last_body_oid{};
+    auto const start{bench_clock::now()};
+    for(uint32_t ix{}; ix != bodies; ++ix)
+      if(auto res{dbs.store(system_address + ix, "Bench"sv, make_body(ix))}; res)
+        last_body_oid = *res;
+    report(batched ? "bodies tx" : "bodies", bodies, bench_clock::now() - start);
+
+    uint32_t const signals{bodies * 4};
+    auto const start_signals{bench_clock::now()};
+    for(uint32_t ix{}; ix != signals; ++ix)
+      [[maybe_unused]]
+      auto const res{dbs.store(last_body_oid - ix % bodies, signal)};
+    report(batched ? "signals tx" : "signals", signals, bench_clock::now() - start_signals);
+    }
+
+  for(uint32_t body_count: {1u, 20u, 100u, 500u})
+    measure_load(dbs, body_count);
+  measure_missions(dbs, 1000);
+  measure_scan(dbs);
+  measure_factions(dbs, 1000);
+  measure_spatial(dbs, 100000);
+  measure_name_search(dbs);
+
+  dbs.close();
+  if(db_path != ":memory:")
+    std::filesystem::remove(db_path);
+  return 0;
+  }
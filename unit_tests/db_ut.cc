@@ -1,8 +1,13 @@
 #include <databse_storage.h>
+#include <database_import_state.h>
+#include "journal_samples.h"
 #include <glaze/glaze.hpp>
+#include <algorithm>
+#include <format>
 #include <print>
 #include <filesystem>
 #include <boost/ut.hpp>
+#include <sqlite3.h>
 #include <spdlog/spdlog.h>
 namespace ut = boost::ut;
 // struct foo_t
@@ -178,5 +183,376 @@ int main()
   ut::expect(loaded.bodies.size() == 1);
   ut::expect(loaded.bodies[0].name == "1"sv);
   ut::expect(std::get<planet_details_t>(loaded.bodies[0].details).planet_class == "High metal content body"sv);
+
+  // child rows of all bodies are loaded with set based queries and attached to owning body
+  body_t second{system.bodies[0]};
+  second.body_id = 8;
+  second.name = "2";
+  std::get<planet_details_t>(second.details).signals_ = {{.Type_Localised = "Biological", .Count = 2}};
+  std::get<planet_details_t>(second.details).genuses_ = {{.Genus_Localised = "Bacterium"}};
+  ut::expect(bool(dbs.store(system.system_address, system.name, second)));
+  auto r9{dbs.load_system(system.system_address)};
+  ut::expect(bool(r9) and r9->has_value());
+  ut::expect((*r9)->bodies.size() == 2);
+  if((*r9)->bodies.size() == 2)
+    {
+    planet_details_t const & first_details{std::get<planet_details_t>((*r9)->bodies[0].details)};
+    planet_details_t const & second_details{std::get<planet_details_t>((*r9)->bodies[1].details)};
+    ut::expect(first_details.signals_.empty());
+    ut::expect(second_details.signals_.size() == 1);
+    ut::expect(second_details.genuses_.size() == 1);
+    }
+
+  // revisited system is served from cache, write touching it drops cached copy
+  uint64_t const hits{dbs.system_cache_.hits_};
+  uint64_t const misses{dbs.system_cache_.misses_};
+  auto r10{dbs.load_system(system.system_address)};
+  ut::expect(bool(r10) and r10->has_value() and (*r10)->bodies.size() == 2);
+  ut::expect(dbs.system_cache_.hits_ == hits + 1);
+  ut::expect(bool(dbs.store_fss_complete(system.system_address)));
+  auto r11{dbs.load_system(system.system_address)};
+  ut::expect(bool(r11) and r11->has_value() and (*r11)->fss_complete);
+  ut::expect(dbs.system_cache_.misses_ == misses + 1);
+
+  // full table scans read rows lazily from their own statement
+  auto systems{dbs.scan_systems()};
+  ut::expect(bool(systems));
+  if(systems)
+    {
+    std::size_t count{};
+    for(star_system_t const & scanned: *systems)
+      {
+      ut::expect(scanned.system_address == system.system_address);
+      ++count;
+      }
+    ut::expect(count == 1u);
+    ut::expect(not systems->error());
+    }
+  auto bodies{dbs.scan_bodies()};
+  ut::expect(bool(bodies));
+  if(bodies)
+    {
+    std::vector<system_body_t> batch;
+    auto first{bodies->next_batch(batch, 1)};
+    ut::expect(bool(first) and *first == 1u);
+    ut::expect(batch.front().system_address == system.system_address);
+    ut::expect(batch.front().body.body_type() == body_type_e::planet);
+    auto rest{bodies->next_batch(batch, 16)};
+    ut::expect(bool(rest) and *rest == 1u and batch.front().body.name == "2"sv);
+    auto done{bodies->next_batch(batch, 16)};
+    ut::expect(bool(done) and *done == 0u);
+    }
+
+  journal_checkpoint_t checkpoint{
+    .journal = "Journal.2026-01-07T104300.01.log",
+    .file_size = 4096,
+    .mtime = 1767782580,
+    .offset = 4000,
+    .last_event = std::chrono::sys_seconds{std::chrono::seconds{1767782580}},
+    .system_address = 3384199352978
+  };
+  ut::expect(bool(dbs.store(checkpoint)));
+  checkpoint.offset = 4096;
+  ut::expect(bool(dbs.store(checkpoint)));
+  checkpoint.journal = "Journal.2026-01-06T080000.01.log";
+  ut::expect(bool(dbs.store(checkpoint)));
+  auto r3{dbs.load_last_checkpoint()};
+  ut::expect(bool(r3));
+  ut::expect(r3->has_value());
+  ut::expect((*r3)->journal == "Journal.2026-01-07T104300.01.log"sv);
+  ut::expect((*r3)->offset == 4096u);
+  ut::expect((*r3)->last_event == checkpoint.last_event);
+  auto r4{dbs.load_checkpoint("Journal.2026-01-05T080000.01.log")};
+  ut::expect(bool(r4));
+  ut::expect(not r4->has_value());
+
+  // values are bound, quotes need no escaping
+  info::faction_info_t faction{.name = "Smith's Crew", .influence = 0.25};
+  ut::expect(bool(dbs.update_faction_info(faction)));
+  auto r5{dbs.load_faction("Smith's Crew")};
+  ut::expect(bool(r5));
+  ut::expect(r5->has_value());
+  ut::expect((*r5)->influence == 0.25);
+  faction.oid = (*r5)->oid;
+  faction.influence = 0.5;
+  ut::expect(bool(dbs.update_faction_info(faction)));
+  auto r6{dbs.load_faction("Smith's Crew")};
+  ut::expect(bool(r6));
+  ut::expect(r6->has_value() and (*r6)->influence == 0.5);
+
+  // factions are upserted by name, unchanged ones are skipped with faction cache
+  std::vector<info::faction_info_t> factions{
+    {.name = "Smith's Crew", .influence = 0.75},
+    {.name = "Oochosy Party", .influence = 0.1}
+  };
+  ut::expect(bool(dbs.sync_factions(factions)));
+  ut::expect(factions[0].oid == faction.oid);
+  ut::expect(factions[1].oid != -1);
+  auto r13{dbs.load_faction("Smith's Crew")};
+  ut::expect(bool(r13) and r13->has_value() and (*r13)->influence == 0.75);
+  ut::expect(dbs.faction_cache_.size() == 2u);
+  ut::expect(bool(dbs.sync_factions(factions)));
+  ut::expect(factions[1].oid == dbs.faction_cache_.at("Oochosy Party").oid);
+
+  // nested scopes join outer transaction, rollback discards its writes
+  ut::expect(bool(dbs.begin_transaction()));
+  ut::expect(bool(dbs.begin_transaction()));
+  ut::expect(bool(dbs.store(info::mission_t{.mission_id = 1001, .status = info::mission_status_e::accepted})));
+  ut::expect(bool(dbs.commit_transaction()));
+  ut::expect(dbs.in_transaction());
+  dbs.rollback_transaction();
+  ut::expect(not dbs.in_transaction());
+  auto r7{dbs.mission_exists(1001)};
+  ut::expect(bool(r7) and not *r7);
+    {
+    transaction_scope_t const transaction{dbs};
+    ut::expect(bool(dbs.store(info::mission_t{.mission_id = 1002, .status = info::mission_status_e::accepted})));
+    }
+  ut::expect(not dbs.in_transaction());
+  auto r8{dbs.mission_exists(1002)};
+  ut::expect(bool(r8) and *r8);
+
+  // hot lookups are served by secondary indexes instead of table scans
+  auto const uses_index = [&dbs](std::string_view query, std::string_view index) -> bool
+  {
+    auto plan{dbs.query_plan(query)};
+    if(not plan)
+      return false;
+    return std::ranges::any_of(*plan, [index](std::string const & detail) { return detail.contains(index); });
+  };
+  ut::expect(uses_index("SELECT oid FROM body WHERE ref_system_address=? AND body_id=?", "body_system_body_id"));
+  ut::expect(uses_index("SELECT oid FROM body WHERE ref_system_address=?", "body_system_body_id"));
+  ut::expect(uses_index(
+    "SELECT type FROM signal WHERE ref_body_oid IN (SELECT oid FROM body WHERE ref_system_address=?)", "signal_body"
+  ));
+  ut::expect(uses_index("SELECT oid FROM planet_details WHERE ref_body_oid=?", "planet_details_body"));
+  ut::expect(uses_index("SELECT oid FROM star_details WHERE ref_body_oid=?", "star_details_body"));
+  ut::expect(uses_index("SELECT oid FROM genus WHERE ref_body_oid=?", "genus_body"));
+  ut::expect(uses_index("SELECT oid FROM ring WHERE ref_system_address=?", "ring_system_parent"));
+  ut::expect(uses_index("SELECT oid FROM faction_info WHERE name=?", "faction_info_name"));
+  ut::expect(uses_index("SELECT mission_id FROM mission WHERE status=? AND expiry>?", "mission_status_expiry"));
+  ut::expect(not bool(dbs.update_faction_info(info::faction_info_t{.name = "Smith's Crew", .influence = 0.1})));
+  dbs.close();
+
+  // schema 2 stored timestamps as ISO text and enums by name, migration rewrites them to integers
+  {
+  sqlite3 * legacy{};
+  ut::expect(sqlite3_open("elite.sqlite", &legacy) == SQLITE_OK);
+  ut::expect(
+    sqlite3_exec(
+      legacy,
+      "DROP TABLE mission;"
+      "CREATE TABLE mission (mission_id INTEGER PRIMARY KEY, status TEXT, expiry TEXT, faction TEXT, type TEXT,"
+      " description TEXT, reward INTEGER, target TEXT, target_type TEXT, target_faction TEXT, destination_system TEXT,"
+      " destination_station TEXT, destination_settlement TEXT, redirected_system TEXT, redirected_station TEXT,"
+      " redirected_settlement TEXT, count INTEGER, kill_count INTEGER, passenger_count INTEGER);"
+      "INSERT INTO mission (mission_id, status, expiry, faction, reward) "
+      "VALUES (2001, 'redirected', '2099-01-01T00:00:00Z', 'Smith''s Crew', 50000);"
+      "PRAGMA user_version=2;",
+      nullptr,
+      nullptr,
+      nullptr
+    )
+    == SQLITE_OK
+  );
+  sqlite3_close(legacy);
+  }
+  database_storage_t migrated{"elite.sqlite"};
+  ut::expect(bool(migrated.open()));
+  auto r12{migrated.load_missions()};
+  ut::expect(bool(r12) and r12->size() == 1u);
+  if(r12 and r12->size() == 1u)
+    {
+    info::mission_t const & m{r12->front()};
+    ut::expect(m.mission_id == 2001u);
+    ut::expect(m.status == info::mission_status_e::redirected);
+    ut::expect(m.expiry == std::chrono::sys_days{std::chrono::year{2099} / 1 / 1});
+    ut::expect(m.faction == "Smith's Crew");
+    ut::expect(m.reward == 50000u);
+    }
+
+  // spatial index follows stored locations, systems at origin have no known location
+  {
+  database_storage_t spatial{":memory:"};
+  ut::expect(bool(spatial.open()));
+  auto const store_at = [&spatial](uint64_t address, info::space_location_t const & location)
+  {
+    ut::expect(bool(spatial.store(star_system_t{
+      .system_address = address,
+      .name = std::format("Spatial {}", address),
+      .star_type = "K",
+      .system_location = location,
+      .bary_centre = {},
+      .bodies = {},
+      .rings = {},
+      .fss_complete = false
+    })));
+  };
+  store_at(1, {10., 0., 0.});
+  store_at(2, {0., 20., 0.});
+  store_at(3, {0., 0., 40.});
+  store_at(4, {});
+  auto r16{spatial.systems_within({0., 0., 0.}, 25.)};
+  ut::expect(bool(r16) and r16->size() == 2u);
+  if(r16 and r16->size() == 2u)
+    {
+    ut::expect(r16->front().system_address == 1u);
+    ut::expect(r16->front().distance == 10.);
+    ut::expect(r16->back().system_address == 2u);
+    }
+  ut::expect(bool(spatial.store_system_location(4, {0., 0., 5.})));
+  ut::expect(bool(spatial.store_system_location(1, {100., 0., 0.})));
+  auto r17{spatial.nearest_systems({0., 0., 0.}, 3)};
+  ut::expect(bool(r17) and r17->size() == 3u);
+  if(r17 and r17->size() == 3u)
+    {
+    ut::expect((*r17)[0].system_address == 4u);
+    ut::expect((*r17)[1].system_address == 2u);
+    ut::expect((*r17)[2].system_address == 3u);
+    }
+  auto r18{spatial.systems_in_box({-1., 15., -1.}, {1., 25., 41.})};
+  ut::expect(bool(r18) and r18->size() == 1u and r18->front().system_address == 2u);
+  }
+
+  // names are indexed on store and found by word prefixes and by similar spelling
+  {
+  database_storage_t names{":memory:"};
+  ut::expect(bool(names.open()));
+  ut::expect(bool(names.store(star_system_t{
+    .system_address = 3932277478106,
+    .name = "Shinrarta Dezhra",
+    .star_type = "K",
+    .system_location = {},
+    .bary_centre = {},
+    .bodies = {},
+    .rings = {},
+    .fss_complete = false
+  })));
+  ut::expect(
+    bool(names.store(3932277478106, "Shinrarta Dezhra", body_t{.body_id = 1, .name = "Shinrarta Dezhra A 1"}))
+  );
+  std::vector<info::faction_info_t> factions{info::faction_info_t{.name = "Pilots Federation Local Branch"}};
+  ut::expect(bool(names.sync_factions(factions)));
+  ut::expect(bool(names.store(info::mission_t{
+    .mission_id = 4001,
+    .status = info::mission_status_e::accepted,
+    .destination_system = "Anana",
+    .destination_station = "Yamazaki Base"
+  })));
+
+  auto r19{names.search_names("shin dez")};
+  ut::expect(bool(r19) and r19->size() == 2u);
+  if(r19 and r19->size() == 2u)
+    {
+    ut::expect(r19->front().kind == name_kind_e::star_system);
+    ut::expect(r19->front().ref == 3932277478106u);
+    ut::expect(r19->back().kind == name_kind_e::body);
+    ut::expect(r19->back().context == "Shinrarta Dezhra");
+    }
+  auto r20{names.search_names("pilots")};
+  ut::expect(bool(r20) and r20->size() == 1u and r20->front().kind == name_kind_e::faction);
+  auto r21{names.search_names("yamazaki")};
+  ut::expect(bool(r21) and r21->size() == 1u and r21->front().ref == 4001u and r21->front().name == "Anana");
+  auto r22{names.search_names_fuzzy("Shinrata")};
+  ut::expect(bool(r22) and not r22->empty());
+  if(r22 and not r22->empty())
+    ut::expect(r22->front().name.starts_with("Shinrarta"));
+  auto r23{names.search_names("\"")};
+  ut::expect(bool(r23) and r23->empty());
+  // ids differing only above bit 61 have separate entries
+  ut::expect(bool(names.store(info::mission_t{
+    .mission_id = (uint64_t{1} << 62) + 4001,
+    .status = info::mission_status_e::accepted,
+    .destination_system = "Borann",
+    .destination_station = "Vinci Dock"
+  })));
+  auto r25{names.search_names("yamazaki")};
+  ut::expect(bool(r25) and r25->size() == 1u and r25->front().ref == 4001u);
+  auto r26{names.search_names("borann")};
+  ut::expect(bool(r26) and r26->size() == 1u and r26->front().ref == (uint64_t{1} << 62) + 4001);
+  // body stored again replaces index entry of its earlier copy
+  ut::expect(
+    bool(names.store(3932277478106, "Shinrarta Dezhra", body_t{.body_id = 1, .name = "Shinrarta Dezhra A 1"}))
+  );
+  auto r29{names.search_names("shin dez")};
+  ut::expect(bool(r29) and r29->size() == 2u);
+  auto r30{names.search_names_fuzzy("Dezhra A 1")};
+  ut::expect(
+    bool(r30) and std::ranges::count(*r30, name_kind_e::body, [](name_match_t const & m) { return m.kind; }) == 1
+  );
+  }
+
+  // import interrupted within journal keeps only events committed together with checkpoint of reached position
+  fs::remove("elite_import.sqlite");
+  {
+  database_import_state_t dbimport{"."};
+  database_import_state_t::state_t state{"elite_import.sqlite"};
+  ut::expect(bool(state.db_.open()));
+  dbimport.state = &state;
+  dbimport.commit_every_ = 2;
+  journal_checkpoint_t const checkpoint{
+    .journal = "Journal.ut.log", .file_size = 100, .mtime = 0, .offset = 100, .last_event = {}, .system_address = 0
+  };
+  ut::expect(bool(state.db_.begin_transaction()));
+  std::array const jump{bench::sample_lines[2], bench::sample_lines[3]};
+  dbimport.process_lines(jump);
+  // open chunk scope is never split
+  ut::expect(bool(state.db_.begin_transaction()));
+  ut::expect(bool(state.db_.commit_pending()));
+  ut::expect(bool(state.db_.commit_transaction()));
+  ut::expect(bool(dbimport.commit_progress(checkpoint)));
+  ut::expect(state.db_.in_transaction());
+  std::array const scan{bench::sample_lines[5]};
+  dbimport.process_lines(scan);
+  // below commit_every_ events since last commit
+  ut::expect(bool(dbimport.commit_progress(journal_checkpoint_t{
+    .journal = checkpoint.journal, .file_size = 200, .mtime = 0, .offset = 200, .last_event = {}, .system_address = 0
+  })));
+  state.db_.rollback_transaction();
+  }
+  {
+  database_storage_t resumed{"elite_import.sqlite"};
+  ut::expect(bool(resumed.open()));
+  auto r27{resumed.load_checkpoint("Journal.ut.log")};
+  ut::expect(bool(r27) and r27->has_value() and (*r27)->offset == 100u);
+  auto r28{resumed.load_system(1184974770842)};
+  ut::expect(bool(r28) and r28->has_value() and (*r28)->bodies.empty());
+  }
+  fs::remove("elite_import.sqlite");
+
+  // database built in memory is persisted atomically with backup api and can be loaded back
+  {
+  database_storage_t memory{":memory:"};
+  ut::expect(bool(memory.open()));
+  ut::expect(bool(memory.store(info::mission_t{.mission_id = 3001, .status = info::mission_status_e::accepted})));
+  ut::expect(bool(memory.save_as("elite_saved.sqlite")));
+  ut::expect(not fs::exists("elite_saved.sqlite.tmp"));
+  }
+  {
+  database_storage_t saved{"elite_saved.sqlite"};
+  ut::expect(bool(saved.open()));
+  auto r14{saved.mission_exists(3001)};
+  ut::expect(bool(r14) and *r14);
+  database_storage_t restored{":memory:"};
+  ut::expect(bool(restored.open()));
+  ut::expect(bool(restored.restore_from("elite_saved.sqlite")));
+  auto r15{restored.mission_exists(3001)};
+  ut::expect(bool(r15) and *r15);
+  // target in write ahead log mode used by other connection is not replaced
+  ut::expect(not restored.save_as("elite_saved.sqlite"));
+  ut::expect(not fs::exists("elite_saved.sqlite.tmp"));
+  }
+  {
+  // log of closed target is checkpointed away so it is not replayed into replaced database
+  database_storage_t memory{":memory:"};
+  ut::expect(bool(memory.open()));
+  ut::expect(bool(memory.save_as("elite_saved.sqlite")));
+  ut::expect(not fs::exists("elite_saved.sqlite-wal") and not fs::exists("elite_saved.sqlite-shm"));
+  database_storage_t saved{"elite_saved.sqlite"};
+  ut::expect(bool(saved.open()));
+  auto r24{saved.mission_exists(3001)};
+  ut::expect(bool(r24) and not *r24);
+  }
+  fs::remove("elite_saved.sqlite");
   return {};
   }
@@ -0,0 +1,58 @@
+#include <elite_events.h>
+#include "journal_samples.h"
+#include <simple_enum/enum_cast.hpp>
+#include <chrono>
+#include <print>
+#include <string>
+#include <vector>
+
+// Event name to event_e lookup, simple_enum::enum_cast vs constexpr perfect hash.
+// usage: event_name_bench [iterations]
+// names are taken from sample journal lines, so distribution follows typical journal
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace
+  {
+template<typename lookup_fn>
+auto measure(
+  std::string_view name, std::vector<std::string> const & names, uint32_t iterations, lookup_fn const & lookup
+) -> void
+  {
+  uint64_t checksum{};
+  auto const start{bench_clock::now()};
+  for(uint32_t i{}; i != iterations; ++i)
+    for(std::string const & event: names)
+      if(std::optional<events::event_e> const e{lookup(std::string_view{event})}; e)
+        checksum += std::to_underlying(*e);
+  double const ns{std::chrono::duration<double, std::nano>(bench_clock::now() - start).count()};
+  double const lookups{static_cast<double>(iterations) * static_cast<double>(names.size())};
+  std::println("{:12} {:8.2f} ns/lookup checksum:{}", name, ns / lookups, checksum);
+  }
+  }  // namespace
+
+auto main(int argc, char ** argv) -> int
+  {
+  uint32_t iterations{1'000'000};
+  if(argc > 1)
+    iterations = static_cast<uint32_t>(std::stoul(argv[1]));
+
+  std::vector<std::string> names;
+  for(std::string_view line: bench::sample_lines)
+    if(std::optional<journal_line_header_t> header{scan_journal_line_header(line)}; header)
+      names.emplace_back(header->event);
+
+  measure(
+    "enum_cast",
+    names,
+    iterations,
+    [](std::string_view event) -> std::optional<events::event_e>
+    {
+      if(auto res{simple_enum::enum_cast<events::event_e>(event)}; res)
+        return *res;
+      return std::nullopt;
+    }
+  );
+  measure("perfect hash", names, iterations, &events::event_from_name);
+  return 0;
+  }
@@ -0,0 +1,114 @@
+#include <journal_import.h>
+#include <database_import_state.h>
+#include "journal_samples.h"
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <print>
+#include <thread>
+#include <vector>
+
+// Scaling of import_journals with number of parsing jobs.
+// usage: import_bench [journal_dir]
+// without journal_dir synthetic journals are generated and only parsing is measured, with journal_dir full import
+// into temporary database is measured as well
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace
+  {
+[[nodiscard]]
+auto job_counts() -> std::vector<uint32_t>
+  {
+  uint32_t const cores{std::max(1u, std::thread::hardware_concurrency())};
+  std::vector<uint32_t> result;
+  for(uint32_t jobs{1}; jobs < cores; jobs *= 2)
+    result.emplace_back(jobs);
+  result.emplace_back(cores);
+  return result;
+  }
+
+[[nodiscard]]
+auto to_tasks(std::vector<fs::path> const & journals) -> std::vector<journal_import_task_t>
+  {
+  std::vector<journal_import_task_t> tasks;
+  for(fs::path const & p: journals)
+    tasks.emplace_back(journal_import_task_t{.journal = p, .start_offset = 0});
+  return tasks;
+  }
+
+template<typename run_fn>
+auto measure(std::string_view name, run_fn const & run) -> void
+  {
+  double baseline{};
+  for(uint32_t jobs: job_counts())
+    {
+    auto const start{bench_clock::now()};
+    run(jobs);
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    if(jobs == 1)
+      baseline = seconds;
+    std::println("{:8} jobs:{:3} time:{:8.3f}s speedup:{:6.2f}", name, jobs, seconds, baseline / seconds);
+    }
+  }
+  }  // namespace
+
+auto main(int argc, char ** argv) -> int
+  {
+  fs::path dir;
+  std::vector<fs::path> journals;
+  if(argc > 1)
+    {
+    dir = argv[1];
+    journals = find_all_journals(dir);
+    }
+  else
+    {
+    dir = fs::temp_directory_path() / "eht_import_bench";
+    for(uint32_t i{}; i != 32; ++i)
+      journals.emplace_back(
+        bench::generate_journal(dir / std::format("Journal.2026-01-{:02}T104300.01.log", i + 1), 8u * 1024u * 1024u)
+      );
+    }
+  if(journals.empty())
+    {
+    std::println(stderr, "no journals in {}", dir.string());
+    return 1;
+    }
+  std::vector<journal_import_task_t> const tasks{to_tasks(journals)};
+
+  // warm page cache
+  for(fs::path const & p: journals)
+    read_file(p, [](std::string_view) {});
+
+  measure(
+    "parse",
+    [&](uint32_t jobs)
+    {
+      bench::null_state_t state{dir.string()};
+      import_journals(tasks, state, jobs);
+    }
+  );
+
+  if(argc > 1)
+    {
+    fs::path const db_path{fs::temp_directory_path() / "eht_import_bench.sqlite"};
+    measure(
+      "import",
+      [&](uint32_t jobs)
+      {
+        fs::remove(db_path);
+        database_import_state_t dbimport{dir.string()};
+        database_import_state_t::state_t state{db_path.string()};
+        if(not state.db_.open())
+          return;
+        dbimport.state = &state;
+        import_journals(tasks, dbimport, jobs);
+      }
+    );
+    fs::remove(db_path);
+    }
+  else
+    fs::remove_all(dir);
+  return 0;
+  }
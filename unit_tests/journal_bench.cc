@@ -0,0 +1,159 @@
+#include <file_io.h>
+#include "journal_samples.h"
+#include <elite_events.h>
+#include <glaze/glaze.hpp>
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <string_view>
+#include <vector>
+
+// Journal reading and parsing throughput.
+// usage: journal_bench [journal_dir]
+// without journal_dir synthetic journal is generated from sample events
+// dispatch section compares lines per second of former two pass parsing (generic_event_t header parse followed by
+// typed parse) with single typed parse after prefix scan of header
+
+using namespace std::string_view_literals;
+using bench_clock = std::chrono::steady_clock;
+
+namespace
+  {
+using reader_fn = auto (*)(fs::path const &, process_callback const &) -> void;
+
+auto read_file_mmap(fs::path const & path, process_callback const & cb) -> void { read_file(path, cb); }
+
+auto measure(std::string_view name, std::vector<fs::path> const & journals, reader_fn reader, fs::path const & dir)
+  -> void
+  {
+  // first pass warms page cache, second one is measured
+  for(uint32_t pass{}; pass != 2; ++pass)
+    {
+    uint64_t bytes{};
+    uint64_t lines{};
+    auto const start{bench_clock::now()};
+    for(fs::path const & p: journals)
+      reader(
+        p,
+        [&bytes, &lines](std::string_view line)
+        {
+          bytes += line.size() + 1;
+          ++lines;
+        }
+      );
+    auto const read_time{bench_clock::now() - start};
+
+    bench::null_state_t state{dir.string()};
+    auto const start_parse{bench_clock::now()};
+    for(fs::path const & p: journals)
+      reader(p, std::bind_front(&generic_state_t::discovery, &state));
+    auto const parse_time{bench_clock::now() - start_parse};
+
+    if(pass == 1)
+      {
+      double const mb{static_cast<double>(bytes) / (1024.0 * 1024.0)};
+      double const read_s{std::chrono::duration<double>(read_time).count()};
+      double const parse_s{std::chrono::duration<double>(parse_time).count()};
+      std::println(
+        "{:8} {:10.1f} MB lines:{:10} read:{:10.1f} MB/s read+parse:{:8.1f} MB/s",
+        name,
+        mb,
+        lines,
+        mb / read_s,
+        mb / parse_s
+      );
+      }
+    }
+  }
+
+inline constexpr glz::opts header_read_opts{
+  []
+  {
+    glz::opts opts{};
+    opts.null_terminated = false;
+    opts.error_on_unknown_keys = false;
+    opts.error_on_missing_keys = false;
+    return opts;
+  }()
+};
+
+template<typename parse_fn>
+auto measure_dispatch(std::string_view name, std::vector<fs::path> const & journals, parse_fn const & parse) -> void
+  {
+  for(uint32_t pass{}; pass != 2; ++pass)
+    {
+    uint64_t lines{};
+    uint64_t events{};
+    auto const start{bench_clock::now()};
+    for(fs::path const & p: journals)
+      read_file_chunks(
+        p,
+        [&](std::span<std::string_view const> chunk)
+        {
+          for(std::string_view line: chunk)
+            {
+            ++lines;
+            if(parse(line))
+              ++events;
+            }
+        }
+      );
+    double const seconds{std::chrono::duration<double>(bench_clock::now() - start).count()};
+    if(pass == 1)
+      std::println(
+        "{:10} lines:{:10} handled:{:10} {:12.0f} lines/s", name, lines, events, static_cast<double>(lines) / seconds
+      );
+    }
+  }
+  }  // namespace
+
+auto main(int argc, char ** argv) -> int
+  {
+  fs::path dir;
+  std::vector<fs::path> journals;
+  if(argc > 1)
+    {
+    dir = argv[1];
+    journals = find_all_journals(dir);
+    }
+  else
+    {
+    dir = fs::temp_directory_path() / "eht_journal_bench";
+    journals.emplace_back(bench::generate_journal(dir / "Journal.2026-01-07T104300.01.log", 128u * 1024u * 1024u));
+    }
+  if(journals.empty())
+    {
+    std::println(stderr, "no journals in {}", dir.string());
+    return 1;
+    }
+
+  measure("ifstream"sv, journals, &read_file_stream, dir);
+  measure("mmap"sv, journals, &read_file_mmap, dir);
+
+  std::string const journal_dir{dir.string()};
+  measure_dispatch(
+    "two pass"sv,
+    journals,
+    [&journal_dir](std::string_view line) -> bool
+    {
+      events::generic_event_t gevt;
+      if(glz::read<header_read_opts>(gevt, line))
+        return false;
+      std::optional<parsed_line_t> parsed{parse_journal_line(journal_dir, line)};
+      return parsed and parsed->event.has_value();
+    }
+  );
+  measure_dispatch(
+    "single"sv,
+    journals,
+    [&journal_dir](std::string_view line) -> bool
+    {
+      std::optional<parsed_line_t> parsed{parse_journal_line(journal_dir, line)};
+      return parsed and parsed->event.has_value();
+    }
+  );
+
+  if(argc <= 1)
+    fs::remove_all(dir);
+  return 0;
+  }
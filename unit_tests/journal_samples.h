@@ -0,0 +1,52 @@
+#pragma once
+#include <file_io.h>
+#include <elite_events.h>
+#include <array>
+#include <fstream>
+#include <string_view>
+
+// synthetic journal content shared by benchmarks
+
+namespace bench
+  {
+using namespace std::string_view_literals;
+
+inline constexpr std::array sample_lines{
+  R"({ "timestamp":"2026-01-07T10:43:00Z", "event":"Music", "MusicTrack":"Exploration" })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:01Z", "event":"ReceiveText", "From":"", "Message":"$COMMS_entered:#name=Col 173 Sector JP-L c9-4;", "Message_Localised":"Entered Channel: Col 173 Sector JP-L c9-4", "Channel":"npc" })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:02Z", "event":"StartJump", "JumpType":"Hyperspace", "Taxi":false, "StarSystem":"Col 173 Sector JP-L c9-4", "SystemAddress":1184974770842, "StarClass":"K" })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:20Z", "event":"FSDJump", "Taxi":false, "Multicrew":false, "StarSystem":"Col 173 Sector JP-L c9-4", "SystemAddress":1184974770842, "StarPos":[1047.06250,-77.56250,-139.81250], "SystemAllegiance":"Independent", "SystemEconomy":"$economy_Extraction;", "SystemEconomy_Localised":"Extraction", "SystemSecondEconomy":"$economy_Industrial;", "SystemSecondEconomy_Localised":"Industrial", "SystemGovernment":"$government_Democracy;", "SystemGovernment_Localised":"Democracy", "SystemSecurity":"$SYSTEM_SECURITY_low;", "SystemSecurity_Localised":"Low Security", "Population":25000, "Body":"Col 173 Sector JP-L c9-4", "BodyID":0, "BodyType":"Star", "JumpDist":38.772, "FuelUsed":3.918474, "FuelLevel":28.081526, "Factions":[ { "Name":"Anana Brotherhood", "FactionState":"None", "Government":"Democracy", "Influence":0.613000, "Allegiance":"Independent", "Happiness":"$Faction_HappinessBand2;", "Happiness_Localised":"Happy", "MyReputation":12.000000 }, { "Name":"Col 173 Sector Crimson Vision Inc", "FactionState":"Boom", "Government":"Corporate", "Influence":0.387000, "Allegiance":"Independent", "Happiness":"$Faction_HappinessBand2;", "Happiness_Localised":"Happy", "MyReputation":0.000000 } ], "SystemFaction":{ "Name":"Anana Brotherhood" } })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:25Z", "event":"FSSDiscoveryScan", "Progress":0.312500, "BodyCount":16, "NonBodyCount":4, "SystemName":"Col 173 Sector JP-L c9-4", "SystemAddress":1184974770842 })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:30Z", "event":"Scan", "ScanType":"Detailed", "BodyName":"Col 173 Sector JP-L c9-4 A 1", "BodyID":7, "Parents":[ {"Star":1}, {"Null":0} ], "StarSystem":"Col 173 Sector JP-L c9-4", "SystemAddress":1184974770842, "DistanceFromArrivalLS":23.417667, "TidalLock":true, "TerraformState":"Terraformable", "PlanetClass":"High metal content body", "Atmosphere":"thick argon rich atmosphere", "AtmosphereType":"ArgonRich", "AtmosphereComposition":[ { "Name":"Argon", "Percent":92.5 }, { "Name":"Nitrogen", "Percent":7.5 } ], "Volcanism":"", "MassEM":0.076945, "Radius":1251308.875000, "SurfaceGravity":1.763689, "SurfaceTemperature":956.597717, "SurfacePressure":0.000000, "Landable":true, "Materials":[ { "Name":"iron", "Percent":21.732067 }, { "Name":"nickel", "Percent":16.437223 }, { "Name":"sulphur", "Percent":15.291922 }, { "Name":"carbon", "Percent":12.858923 } ], "Composition":{ "Ice":0.000000, "Rock":0.669066, "Metal":0.330934 }, "SemiMajorAxis":7026505589.485168, "Eccentricity":0.000985, "OrbitalInclination":-0.013204, "Periapsis":338.519857, "OrbitalPeriod":341110.241413, "AscendingNode":82.022338, "MeanAnomaly":28.719750, "RotationPeriod":341110.368400, "AxialTilt":0.084878, "WasDiscovered":true, "WasMapped":false, "WasFootfalled":false })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:31Z", "event":"FSSBodySignals", "BodyName":"Col 173 Sector JP-L c9-4 A 1", "BodyID":7, "SystemAddress":1184974770842, "Signals":[ { "Type":"$SAA_SignalType_Biological;", "Type_Localised":"Biological", "Count":2 } ] })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:32Z", "event":"ShipTargeted", "TargetLocked":false })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:33Z", "event":"FuelScoop", "Scooped":5.000000, "Total":32.000000 })"sv,
+  R"({ "timestamp":"2026-01-07T10:43:34Z", "event":"FSDTarget", "Name":"Col 173 Sector JP-L c9-5", "SystemAddress":1184974770843, "StarClass":"M", "RemainingJumpsInRoute":3 })"sv,
+};
+
+///\brief counts events without storing them, measures parsing only
+struct null_state_t : public generic_state_t
+  {
+  uint64_t count{};
+
+  using generic_state_t::generic_state_t;
+
+  void handle(std::chrono::sys_seconds, events::event_holder_t const &) override { ++count; }
+  };
+
+///\brief writes sample lines repeatedly until file has at least target_bytes
+[[nodiscard]]
+inline auto generate_journal(fs::path const & path, std::size_t target_bytes) -> fs::path
+  {
+  fs::create_directories(path.parent_path());
+  std::ofstream out{path, std::ios::out | std::ios::trunc};
+  std::size_t written{};
+  while(written < target_bytes)
+    for(std::string_view line: sample_lines)
+      {
+      out << line << '\n';
+      written += line.size() + 1;
+      }
+  return path;
+  }
+  }  // namespace bench
@@ -0,0 +1,88 @@
+#include <boost/ut.hpp>
+#include <elite_events.h>
+#include "journal_samples.h"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace
+  {
+std::atomic<uint64_t> allocations{};
+
+///\brief keeps copy of last event of each type like real handlers keep jump_info, next_target or loadout
+struct copying_state_t : public generic_state_t
+  {
+  uint64_t count{};
+  std::array<std::optional<events::event_holder_t>, std::variant_size_v<events::event_holder_t>> kept;
+
+  using generic_state_t::generic_state_t;
+
+  void handle(std::chrono::sys_seconds, events::event_holder_t const & event) override
+    {
+    // copy assignment to the same alternative reuses capacity of kept copy
+    kept[event.index()] = event;
+    ++count;
+    }
+  };
+  }  // namespace
+
+auto operator new(std::size_t size) -> void *
+  {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void * ptr{std::malloc(size == 0 ? 1 : size)}; ptr != nullptr)
+    return ptr;
+  throw std::bad_alloc{};
+  }
+
+auto operator delete(void * ptr) noexcept -> void { std::free(ptr); }
+
+auto operator delete(void * ptr, std::size_t) noexcept -> void { std::free(ptr); }
+
+auto main() -> int
+  {
+  using namespace boost::ut;
+  using namespace std::string_view_literals;
+
+  "steady_state_parse_does_not_allocate"_test = []
+  {
+    copying_state_t state{"."};
+    std::vector<std::string_view> const lines{bench::sample_lines.begin(), bench::sample_lines.end()};
+
+    // first passes size buffers and cached events
+    for(uint32_t pass{}; pass != 3; ++pass)
+      for(std::string_view line: lines)
+        state.discovery(line);
+    uint64_t const handled{state.count};
+    uint64_t const per_pass{handled / 3u};
+
+    uint64_t const before{allocations.load()};
+    for(uint32_t pass{}; pass != 100; ++pass)
+      for(std::string_view line: lines)
+        state.discovery(line);
+    uint64_t const after{allocations.load()};
+
+    expect(eq(after - before, 0u)) << "allocations in steady state";
+    expect(eq(state.count, handled + per_pass * 100u));
+  };
+
+  "reused_event_does_not_keep_previous_values"_test = []
+  {
+    parser_context_t context;
+    auto const star{parse_journal_line(
+      context,
+      "."sv,
+      R"({ "timestamp":"2026-01-07T10:43:00Z", "event":"Scan", "ScanType":"Detailed", "BodyName":"A", "BodyID":0, "StarSystem":"S", "SystemAddress":1, "DistanceFromArrivalLS":0.0, "StarType":"K", "Subclass":9, "StellarMass":0.5, "Radius":480193792.0, "AbsoluteMagnitude":7.4, "Age_MY":1938, "SurfaceTemperature":3811.0, "Luminosity":"Va", "WasDiscovered":true, "WasMapped":false })"sv
+    )};
+    expect(star.has_value() and star->event != nullptr);
+    expect(std::get<events::scan_detailed_scan_t>(*star->event).Luminosity == "Va"sv);
+
+    auto const planet{parse_journal_line(context, "."sv, bench::sample_lines[5])};
+    expect(planet.has_value() and planet->event != nullptr);
+    expect(std::get<events::scan_detailed_scan_t>(*planet->event).Luminosity.empty());
+    expect(std::get<events::scan_detailed_scan_t>(*planet->event).PlanetClass == "High metal content body"sv);
+  };
+  }
@@ -0,0 +1,51 @@
+#include <boost/ut.hpp>
+#include <read_pool.h>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+auto main() -> int
+  {
+  using namespace boost::ut;
+
+  "readers_run_concurrently_with_open_write_transaction"_test = []
+  {
+    fs::remove("read_pool.sqlite");
+      {
+      database_storage_t writer{"read_pool.sqlite"};
+      expect(bool(writer.open()));
+      expect(bool(writer.store(info::mission_t{.mission_id = 1, .status = info::mission_status_e::accepted})));
+      read_pool_t readers;
+      expect(bool(readers.open("read_pool.sqlite", 2)));
+      expect(readers.is_open());
+
+      expect(bool(writer.begin_transaction()));
+      expect(bool(writer.store(info::mission_t{.mission_id = 2, .status = info::mission_status_e::accepted})));
+      // readers see last committed state without waiting for writer
+      auto committed{readers.call([](database_storage_t & db) { return db.mission_exists(1); })};
+      expect(bool(committed) and *committed);
+      auto pending{readers.call([](database_storage_t & db) { return db.mission_exists(2); })};
+      expect(bool(pending) and not *pending);
+      expect(bool(writer.commit_transaction()));
+      auto visible{readers.call([](database_storage_t & db) { return db.mission_exists(2); })};
+      expect(bool(visible) and *visible);
+
+      expect(writer.wal_pages_ > 0u);
+      expect(bool(writer.checkpoint()));
+      expect(writer.wal_pages_ == 0u);
+      }
+    fs::remove("read_pool.sqlite");
+  };
+
+  "read_only_connection_requires_existing_database"_test = []
+  {
+    fs::remove("read_pool_missing.sqlite");
+    read_pool_t readers;
+    expect(not readers.open("read_pool_missing.sqlite", 1));
+    expect(not readers.is_open());
+    expect(not fs::exists("read_pool_missing.sqlite"));
+    // call on pool without workers fails instead of waiting forever
+    auto res{readers.call([](database_storage_t & db) { return db.mission_exists(1); })};
+    expect(not res and res.error() == std::errc::not_connected);
+  };
+  }
@@ -0,0 +1,89 @@
+#include <boost/ut.hpp>
+#include <storage_queue.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+auto main() -> int
+  {
+  using namespace boost::ut;
+
+  "tasks_are_applied_in_order"_test = []
+  {
+    database_storage_t db{":memory:"};
+    expect(bool(db.open()));
+    std::vector<uint64_t> order;
+      {
+      storage_queue_t storage{db, 4};
+      // slow first task keeps storage thread busy so producer fills queue
+      storage.push([](database_storage_t &) { std::this_thread::sleep_for(std::chrono::milliseconds{20}); });
+      for(uint64_t ix{}; ix != 100; ++ix)
+        storage.push(
+          [ix, &order](database_storage_t & dbs)
+          {
+            if(not dbs.store(info::mission_t{.mission_id = ix, .status = info::mission_status_e::accepted}))
+              return;
+            order.push_back(ix);
+          }
+        );
+      // reads queued behind writes observe them
+      auto exists{storage.call([](database_storage_t & dbs) { return dbs.mission_exists(99); })};
+      expect(bool(exists) and *exists);
+      storage.flush();
+      expect(storage.stats_.stalls.load() > 0u);
+      expect(storage.stats_.applied.load() == 102u);
+      }
+    expect(order.size() == 100u);
+    expect(std::ranges::is_sorted(order));
+  };
+
+  "pending_tasks_are_applied_on_destruction"_test = []
+  {
+    database_storage_t db{":memory:"};
+    expect(bool(db.open()));
+      {
+      storage_queue_t storage{db};
+      storage.push([](database_storage_t &) { std::this_thread::sleep_for(std::chrono::milliseconds{50}); });
+      storage.push(
+        [](database_storage_t & dbs)
+        {
+          [[maybe_unused]]
+          auto const res{dbs.store(info::mission_t{.mission_id = 7, .status = info::mission_status_e::accepted})};
+        }
+      );
+      }
+    expect(not db.in_transaction());
+    auto exists{db.mission_exists(7)};
+    expect(bool(exists) and *exists);
+  };
+
+  "after_commit_runs_when_batch_is_committed"_test = []
+  {
+    database_storage_t db{":memory:"};
+    expect(bool(db.open()));
+    storage_queue_t storage{db};
+    std::atomic<bool> in_transaction{true};
+    storage.push(
+      [&storage, &in_transaction](database_storage_t & dbs)
+      {
+        storage.after_commit([&dbs, &in_transaction] { in_transaction = dbs.in_transaction(); });
+      }
+    );
+    storage.flush();
+    expect(not in_transaction.load());
+  };
+
+  "flush_waits_for_queued_tasks"_test = []
+  {
+    database_storage_t db{":memory:"};
+    expect(bool(db.open()));
+    storage_queue_t storage{db};
+    std::atomic<uint32_t> applied{};
+    for(uint32_t ix{}; ix != 10; ++ix)
+      storage.push([&applied](database_storage_t &) { applied.fetch_add(1, std::memory_order_relaxed); });
+    storage.flush();
+    expect(applied.load() == 10u);
+  };
+  }
@@ -0,0 +1,121 @@
+#include <file_io.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Measures event-to-callback latency of appended journal lines and idle wakeups per second of tail_file.
+// usage: tail_bench [lines] [interval_ms] [idle_s]
+
+using std::chrono::steady_clock;
+
+namespace
+  {
+struct bench_config_t
+  {
+  uint32_t lines{200};
+  std::chrono::milliseconds interval{5};
+  std::chrono::seconds idle{3};
+  };
+
+[[nodiscard]]
+auto now_ns() noexcept -> int64_t
+  {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+[[nodiscard]]
+auto percentile(std::vector<int64_t> & values, double p) -> double
+  {
+  if(values.empty())
+    return 0.0;
+  std::ranges::sort(values);
+  auto const ix{static_cast<std::size_t>(p * static_cast<double>(values.size() - 1))};
+  return static_cast<double>(values[ix]) / 1000.0;
+  }
+
+auto run(tail_mode_e mode, fs::path const & path, bench_config_t const & cfg) -> void
+  {
+  if(fs::exists(path))
+    fs::remove(path);
+  int const out{::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)};
+  if(out < 0)
+    {
+    std::println(stderr, "can not create {}", path.string());
+    return;
+    }
+
+  std::vector<int64_t> latencies;
+  latencies.reserve(cfg.lines);
+  tail_stats_t stats;
+
+  std::jthread tail{
+    [&](std::stop_token stoken)
+    {
+      tail_file(
+        path,
+        [&latencies](std::string_view line)
+        {
+          int64_t const received{now_ns()};
+          int64_t sent{};
+          std::from_chars(line.data(), line.data() + line.size(), sent);
+          latencies.push_back(received - sent);
+        },
+        stoken,
+        tail_options_t{.mode = mode, .stats = &stats}
+      );
+    }
+  };
+  // let tailer reach its wait state
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  for(uint32_t i{}; i != cfg.lines; ++i)
+    {
+    std::string const line{std::format("{}\n", now_ns())};
+    [[maybe_unused]]
+    auto const res{::write(out, line.data(), line.size())};
+    std::this_thread::sleep_for(cfg.interval);
+    }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  uint64_t const wakeups_before{stats.wakeups.load()};
+  std::this_thread::sleep_for(cfg.idle);
+  uint64_t const idle_wakeups{stats.wakeups.load() - wakeups_before};
+
+  tail.request_stop();
+  tail.join();
+  ::close(out);
+
+  std::println(
+    "{:8} lines:{:5} latency[us] p50:{:10.1f} p99:{:10.1f} max:{:10.1f} idle wakeups/s:{:6.1f}",
+    simple_enum::enum_name(mode),
+    stats.lines.load(),
+    percentile(latencies, 0.5),
+    percentile(latencies, 0.99),
+    percentile(latencies, 1.0),
+    static_cast<double>(idle_wakeups) / static_cast<double>(cfg.idle.count())
+  );
+  fs::remove(path);
+  }
+  }  // namespace
+
+auto main(int argc, char ** argv) -> int
+  {
+  bench_config_t cfg;
+  if(argc > 1)
+    cfg.lines = static_cast<uint32_t>(std::stoul(argv[1]));
+  if(argc > 2)
+    cfg.interval = std::chrono::milliseconds{std::stol(argv[2])};
+  if(argc > 3)
+    cfg.idle = std::chrono::seconds{std::stol(argv[3])};
+
+  fs::path const path{fs::temp_directory_path() / "eht_tail_bench.log"};
+  run(tail_mode_e::polling, path, cfg);
+  run(tail_mode_e::inotify, path, cfg);
+  return 0;
+  }